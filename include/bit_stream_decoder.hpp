@@ -11,6 +11,7 @@
 
 #include "l2/lower_mac.hpp"
 #include "streaming_ordered_output_thread_pool_executor.hpp"
+#include "utils/burst_peak_picker.hpp"
 #include <memory>
 #include <vector>
 
@@ -36,10 +37,18 @@ class BitStreamDecoder {
   public:
     BitStreamDecoder(
         const std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>>& lower_mac_worker_queue,
-        const std::shared_ptr<LowerMac>& lower_mac, bool is_uplink)
+        const std::shared_ptr<LowerMac>& lower_mac, bool is_uplink,
+        const std::shared_ptr<PrometheusExporter>& prometheus_exporter = nullptr)
         : lower_mac_worker_queue_(lower_mac_worker_queue)
         , lower_mac_(lower_mac)
-        , is_uplink_(is_uplink){};
+        , is_uplink_(is_uplink)
+        , uplink_burst_peak_picker_(
+              kUplinkBurstPeakWindow,
+              [this](UplinkBurst&& burst) {
+                  lower_mac_worker_queue_->queue_work(
+                      std::bind(&LowerMac::process, lower_mac_, std::move(burst.bits), burst.burst_type));
+              },
+              prometheus_exporter){};
     ~BitStreamDecoder() = default;
 
     /**
@@ -55,18 +64,43 @@ class BitStreamDecoder {
      */
     void process_bit(uint8_t symbol) noexcept;
 
+    /// Pass the last detected uplink burst to the lower mac at the end of the stream
+    void flush() { uplink_burst_peak_picker_.flush(); };
+
   private:
     /// The pointer to the worker queue
     std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>> lower_mac_worker_queue_;
 
     std::shared_ptr<LowerMac> lower_mac_;
 
+    /// true if the downlink bursts are tracked. The position of the next burst is known and only a small window
+    /// around it is searched for the training sequence.
     bool is_synchronized_ = false;
     bool is_uplink_{};
-    std::size_t sync_bit_counter_ = 0;
+
+    /// An uplink burst detected in the bit stream
+    struct UplinkBurst {
+        BurstType burst_type;
+        /// the bits of the burst
+        std::vector<uint8_t> bits;
+    };
+
+    /// The maximum distance in bits of uplink burst detections that belong to the same burst
+    static constexpr std::size_t kUplinkBurstPeakWindow = 32;
+    /// The number of received bits on the uplink
+    std::size_t uplink_bit_position_ = 0;
+    /// Select the best detection out of adjacent detections of the same uplink burst
+    BurstPeakPicker<UplinkBurst> uplink_burst_peak_picker_;
+    /// the number of consecutive bursts for which the training sequence was not found while tracking
+    std::size_t missed_bursts_ = 0;
 
     const std::size_t kFRAME_LEN = 510;
 
+    /// the number of bits the downlink burst is searched for on both sides of its expected position while tracking
+    const std::size_t kTRACKING_WINDOW = 4;
+    /// the number of consecutive bursts without training sequence after which the synchronization is lost
+    const std::size_t kMAX_MISSED_BURSTS = 50;
+
     std::vector<uint8_t> frame_{};
 
     // 9.4.4.3.2 Normal training sequence
@@ -89,17 +123,42 @@ class BitStreamDecoder {
      * @brief Reset the synchronizer
      *
      * Burst was matched, we can reset the synchronizer to allow 50 missing frames
-     * (expressed in burst units = 50 * 510 bits)
      *
      */
     void reset_synchronizer() noexcept;
 
+    /**
+     * @brief Search the downlink burst at the start of the frame. This is done for every received bit until the
+     * first burst is found.
+     *
+     */
+    void search_downlink_burst() noexcept;
+
+    /**
+     * @brief Process the downlink burst that is expected one burst length after the previous one. The training
+     * sequence is searched in a small window to follow drift. This is done once per burst.
+     *
+     */
+    void track_downlink_burst() noexcept;
+
+    /**
+     * @brief Check if a normal or synchronization continous downlink burst starts at a position in the frame
+     *
+     * @param position  Position in the frame where the burst should start
+     *
+     * @return true if the training sequence 3 is found at the beginning and end of the burst
+     *
+     */
+    [[nodiscard]] auto is_downlink_burst_at_position(std::size_t position) const noexcept -> bool;
+
     /**
      * @brief Process frame to decide which type of burst it is then service lower
      * MAC
      *
+     * @param position  Position in the frame where the burst starts
+     *
      */
-    void process_downlink_frame() noexcept;
+    void process_downlink_frame(std::size_t position) noexcept;
 
     /**
      * @brief Return pattern/data comparison errors count at position in data
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <zlib.h>
+
+/// The Content-Encoding of the requests that are sent to borzoi
+enum class BorzoiCompression {
+    /// the body is sent as is
+    kNone,
+    /// the body is compressed with a gzip header (RFC 1952)
+    kGzip,
+    /// the body is compressed with a zlib header (RFC 1950), as HTTP defines deflate
+    kDeflate,
+};
+
+constexpr auto to_string(BorzoiCompression compression) noexcept -> const char* {
+    switch (compression) {
+    case BorzoiCompression::kNone:
+        return "none";
+    case BorzoiCompression::kGzip:
+        return "gzip";
+    case BorzoiCompression::kDeflate:
+        return "deflate";
+    }
+};
+
+/// Parse the compression from its command line representation
+/// \param name the name of the compression (none, gzip or deflate)
+/// \return the parsed compression
+[[nodiscard]] auto borzoi_compression_from_string(const std::string& name) -> BorzoiCompression;
+
+/// Compresses the bodies of the requests of one connection. The zlib state is reused between the requests.
+class BorzoiCompressor {
+  public:
+    BorzoiCompressor() = delete;
+
+    /// \param compression the Content-Encoding of the compressed bodies. Must not be kNone.
+    /// \param level the zlib compression level from 0 (no compression) to 9 (best compression) or -1 (the zlib default)
+    BorzoiCompressor(BorzoiCompression compression, int level);
+
+    ~BorzoiCompressor();
+
+    /// Check a zlib compression level. Throws if it is not between -1 and 9.
+    /// \param level the zlib compression level
+    static auto check_level(int level) -> void;
+
+    BorzoiCompressor(const BorzoiCompressor&) = delete;
+    auto operator=(const BorzoiCompressor&) -> BorzoiCompressor& = delete;
+    BorzoiCompressor(BorzoiCompressor&&) = delete;
+    auto operator=(BorzoiCompressor&&) -> BorzoiCompressor& = delete;
+
+    /// Compress a request body
+    /// \param body the uncompressed body
+    /// \return the compressed body
+    [[nodiscard]] auto compress(const std::string& body) -> std::string;
+
+  private:
+    /// The zlib state
+    std::unique_ptr<z_stream> stream_;
+};
@@ -0,0 +1,31 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <cstddef>
+
+/// The endpoints of borzoi to which packets are sent
+enum class BorzoiEndpoint {
+    /// the endpoint for parsed packets
+    kPacket,
+    /// the endpoint for slots that failed to decode
+    kFailedSlots,
+};
+
+constexpr auto to_string(BorzoiEndpoint endpoint) noexcept -> const char* {
+    switch (endpoint) {
+    case BorzoiEndpoint::kPacket:
+        return "Packet";
+    case BorzoiEndpoint::kFailedSlots:
+        return "Failed Slots";
+    }
+};
+
+/// The number of borzoi endpoints
+constexpr std::size_t kBorzoiEndpointCount = 2;
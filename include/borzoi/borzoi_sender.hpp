@@ -8,48 +8,280 @@
 
 #pragma once
 
-#include "l2/logical_link_control_packet.hpp"
-#include "l2/slot.hpp"
+#include "borzoi/borzoi_compression.hpp"
+#include "borzoi/borzoi_endpoint.hpp"
+#include "borzoi/borzoi_sender_metrics.hpp"
+#include "borzoi/borzoi_spool.hpp"
+#include "borzoi/borzoi_wire_format.hpp"
+#include "output/output_sink_queue.hpp"
+#include "prometheus.h"
 #include "thread_safe_fifo.hpp"
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cpr/cpr.h>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
 #include <thread>
-#include <variant>
+#include <vector>
+
+/// The options of the delivery of packets to borzoi
+struct BorzoiSenderOptions {
+    /// The maximum number of packets that wait in the queue of the sender. Further packets are dropped.
+    std::size_t queue_capacity = 100000;
+    /// The encoding of the packets and the Content-Type of the requests
+    BorzoiWireFormat wire_format = BorzoiWireFormat::kJson;
+    /// The Content-Encoding of the request bodies
+    BorzoiCompression compression = BorzoiCompression::kNone;
+    /// The zlib compression level from 0 to 9 or -1 for the zlib default
+    int compression_level = -1;
+    /// The maximum number of packets that are sent in one request. If this is one, every packet is sent as a single
+    /// object. Otherwise the packets are sent as an array.
+    std::size_t batch_size = 1;
+    /// The maximum time a packet waits in a batch before the batch is sent
+    std::chrono::milliseconds batch_max_latency = std::chrono::milliseconds(100);
+    /// The number of connections to borzoi which send requests concurrently
+    std::size_t connection_count = 1;
+    /// The maximum number of requests that are queued or sent on all connections
+    std::size_t max_in_flight = 16;
+    /// The directory of the spool that stores packets which could not be delivered. The spool is disabled if this is
+    /// not set.
+    std::optional<std::string> spool_directory;
+    /// The maximum size of the spool on the disk
+    std::size_t spool_max_bytes = std::size_t{1} << 30;
+    /// The size after which the spool starts a new segment
+    std::size_t spool_segment_bytes = std::size_t{16} << 20;
+    /// When the spool flushes written packets to the disk
+    BorzoiSpoolSyncPolicy spool_sync_policy = BorzoiSpoolSyncPolicy::kSegment;
+    /// The number of packets in the input queue above which new packets are written to the spool
+    std::size_t spool_queue_threshold = 10000;
+};
 
 class BorzoiSender {
   public:
     BorzoiSender() = delete;
 
     /// This class sends the HTTP Post requests to borzoi. https://github.com/tlm-solutions/borzoi
-    /// \param queue the queue holds either the parsed packets (std::unique_ptr<LogicalLinkControlPacket>) or Slots that
-    /// failed to decode
+    /// The requests are sent concurrently on multiple connections. All packets of the same mobile station and all
+    /// failed slots are sent on the same connection and therefore arrive in order.
+    /// If the spool is enabled, packets of failed requests are written to it. While borzoi is not reachable, the spool
+    /// is not empty or the input queue is too long, new packets are written to the spool as well. Only the worker
+    /// thread writes to the spool: the connections return failed requests to it, and before the first packet is
+    /// written to the spool it waits for all requests on the connections. The spool is replayed on all connections
+    /// with up to the maximum number of requests in flight. The packets of a connection are replayed in order and a
+    /// replayed packet is only removed from the spool after borzoi accepted or rejected it. Therefore the packets are
+    /// delivered at least once and the packets of a mobile station arrive in order. Packets that were replayed but not
+    /// committed before a crash or termination are sent again.
+    /// Only transport errors, server errors and 429 Too Many Requests are retried. Packets that borzoi rejects with
+    /// another status are reported and dropped.
+    /// \param queue the queue of this sink in the output fan-out
     /// \param termination_flag this flag is set when the sender should terminate after finishing all work
     /// \param borzoi_url the URL of borzoi
-    /// \param borzoi_uuid the station UUID of this instance of tetra-decoder sending to borzoi
-    BorzoiSender(ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue,
-                 std::atomic_bool& termination_flag, const std::string& borzoi_url, std::string borzoi_uuid);
+    /// \param options the options of the delivery to borzoi
+    /// \param prometheus_exporter the reference to the prometheus exporter that is used for the metrics in the borzoi
+    /// sender
+    BorzoiSender(std::shared_ptr<OutputSinkQueue> queue, std::atomic_bool& termination_flag,
+                 const std::string& borzoi_url, const BorzoiSenderOptions& options,
+                 const std::shared_ptr<PrometheusExporter>& prometheus_exporter);
 
     ~BorzoiSender();
 
+    /// Check the options of the sender, the spool and the compression. Throws if the sender cannot be created with
+    /// them. This allows to report invalid command line options before any thread is started.
+    /// \param options the options of the sender
+    static auto check_options(const BorzoiSenderOptions& options) -> void;
+
   private:
+    /// The result of a request to borzoi
+    enum class RequestResult {
+        /// borzoi accepted the packets
+        kDelivered,
+        /// borzoi rejected the packets. Sending them again would fail the same way.
+        kRejected,
+        /// borzoi was not reachable or overloaded. The packets can be sent again later.
+        kFailed,
+    };
+
+    /// A request that is sent to borzoi on a connection
+    struct Request {
+        /// the endpoint to which the request is sent
+        BorzoiEndpoint endpoint;
+        /// the value that selected the connection. The packets are written to the spool with it if the request fails.
+        uint64_t route = 0;
+        /// the serialized packets in the request
+        std::vector<std::string> packets;
+        /// the positions of the packets in the spool if they are replayed from it
+        std::vector<uint64_t> replay_positions;
+    };
+
+    /// A request that is returned from a connection to the worker thread
+    struct Completion {
+        /// the request that was sent
+        Request request;
+        /// the result of the request
+        RequestResult result = RequestResult::kFailed;
+    };
+
+    /// A packet of the spool that is replayed
+    struct ReplayRecord {
+        enum class State {
+            /// the packet waits to be sent
+            kPending,
+            /// the packet is in a request on a connection
+            kSent,
+            /// borzoi accepted the packet, it is committed once all packets before it are done
+            kDelivered,
+            /// the packet can never be delivered, it is dropped once all packets before it are done
+            kDropped,
+        };
+
+        /// the endpoint to which the packet is sent
+        BorzoiEndpoint endpoint;
+        /// the value that selects the connection on which the packet is sent
+        uint64_t route = 0;
+        /// the serialized packet in the current wire format
+        std::string payload;
+        /// the state of the replay of the packet
+        State state = State::kPending;
+    };
+
+    /// The packets that wait to be sent to an endpoint in one request
+    struct Batch {
+        /// The serialized packets that are not yet sent
+        std::vector<std::string> packets;
+        /// The time at which the first packet of the batch was added
+        std::chrono::steady_clock::time_point start;
+    };
+
+    /// A connection to borzoi with its keep-alive sessions for each endpoint
+    struct Connection {
+        /// The position of the connection in the list of connections
+        std::size_t index = 0;
+        /// The sessions that keep the connection to borzoi open between requests. Only used by the connection thread.
+        std::array<cpr::Session, kBorzoiEndpointCount> sessions;
+        /// The compressor of the request bodies if compression is enabled. Only used by the connection thread.
+        std::unique_ptr<BorzoiCompressor> compressor;
+        /// The batches of each endpoint that wait to be sent on this connection. Only used by the worker thread.
+        std::array<Batch, kBorzoiEndpointCount> batches;
+        /// The requests that wait to be sent on this connection
+        ThreadSafeFifo<Request> requests;
+        /// The number of replayed requests that are queued or sent on this connection. Only used by the worker thread.
+        std::size_t replay_in_flight = 0;
+        /// The flag that is set by the connection thread when a replayed request failed. The following replayed
+        /// requests are returned without sending them to keep their packets in order. The worker thread clears it
+        /// when all replayed requests of the connection are returned.
+        std::atomic_bool replay_failed = false;
+        /// The thread sending the requests
+        std::thread thread;
+    };
+
     /// The thread function for continously process incomming parsed packets or failed slots.
     auto worker() -> void;
 
-    void send_packet(const std::unique_ptr<LogicalLinkControlPacket>& packet);
-    void send_failed_slots(const Slots& slots);
+    /// The thread function of a connection that sends its requests in order.
+    /// \param connection the connection to borzoi
+    auto connection_worker(Connection& connection) -> void;
+
+    /// Serialize a packet in the wire format and pass it on for sending
+    auto send(const OutputPacket& packet) -> void;
+
+    /// Check if new packets are written to the spool
+    [[nodiscard]] auto spooling() -> bool;
+
+    /// Stop sending new packets to borzoi before they are written to the spool. Waits until all requests on the
+    /// connections finished, processes the returned requests and moves the batches into the spool. The packets of
+    /// each connection therefore stay in order.
+    auto spool_live_requests() -> void;
+
+    /// Process the requests that the connections returned. Failed requests are written to the spool and the results
+    /// of replayed requests are applied to the replay window.
+    auto process_completions() -> void;
+
+    /// Commit or drop the packets at the start of the replay window that are done
+    auto commit_replayed() -> void;
+
+    /// Write the packets of a request or batch to the spool
+    /// \param endpoint the endpoint to which the packets are sent
+    /// \param route the value that selects the connection on which the packets are sent
+    /// \param packets the serialized packets
+    auto spool_packets(BorzoiEndpoint endpoint, uint64_t route, std::vector<std::string>& packets) -> void;
+
+    /// Write a serialized packet to the spool if it is in use, otherwise add it to the batch of its connection
+    /// \param endpoint the endpoint to which the packet is sent
+    /// \param route the value that selects the connection on which the packet is sent
+    /// \param payload the serialized packet
+    auto dispatch(BorzoiEndpoint endpoint, uint64_t route, std::string&& payload) -> void;
+
+    /// Read the oldest packets of the spool into the replay window and send the pending ones. Each request holds the
+    /// oldest pending packets of a connection and endpoint. While requests fail only a single request is sent per
+    /// probe interval.
+    auto replay_spool() -> void;
+
+    /// Add a serialized packet to the batch of an endpoint and send the batch if it is full
+    auto enqueue(Connection& connection, BorzoiEndpoint endpoint, std::string&& payload) -> void;
+
+    /// Send the batches of all connections where the first packet has waited for the maximum latency
+    auto flush_expired() -> void;
+
+    /// Send all packets in the batch of an endpoint in one request. Blocks while the maximum number of requests are in
+    /// flight.
+    auto flush(Connection& connection, BorzoiEndpoint endpoint) -> void;
+
+    /// Send a request to borzoi. Its packets are reported if borzoi rejected them or if the request failed and the
+    /// spool is not in use.
+    /// \return the result of the request
+    auto post(Connection& connection, const Request& request) -> RequestResult;
 
     /// The input queue
-    ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue_;
+    std::shared_ptr<OutputSinkQueue> queue_;
 
     /// The flag that is set when terminating the program
     std::atomic_bool& termination_flag_;
 
-    /// The urls of borzoi
-    cpr::Url borzoi_url_sds_;
-    cpr::Url borzoi_url_failed_slots_;
+    /// The options of the delivery to borzoi
+    BorzoiSenderOptions options_;
+
+    /// The connections to borzoi
+    std::vector<std::unique_ptr<Connection>> connections_;
+
+    /// The number of requests that are queued or sent on all connections. Replayed requests are not counted.
+    std::size_t in_flight_ = 0;
+    /// The mutex for the number of requests in flight
+    std::mutex in_flight_mutex_;
+    /// The condition variable that is notified when a request was sent
+    std::condition_variable in_flight_cv_;
+
+    /// The flag that is set when the connections should terminate after sending all queued requests
+    std::atomic_bool connection_termination_flag_ = false;
+
+    /// The time between attempts to replay the spool while requests fail
+    static constexpr std::chrono::seconds kSpoolProbeInterval = std::chrono::seconds(1);
+
+    /// The spool for packets that could not be delivered
+    std::unique_ptr<BorzoiSpool> spool_;
+    /// The flag that is set when a request failed and cleared when a replayed request was delivered. While it is set,
+    /// the connections return their queued requests without sending them.
+    std::atomic_bool delivery_failing_ = false;
+    /// The requests that the connections return to the worker thread: failed requests and all replayed requests
+    ThreadSafeFifo<Completion> completions_;
+    /// The packets of the spool that are replayed, starting at the head of the spool. Only used by the worker thread.
+    std::deque<ReplayRecord> replay_window_;
+    /// The position in the spool of the first packet in the replay window
+    uint64_t replay_window_position_ = 0;
+    /// The number of replayed requests that are queued or sent on all connections
+    std::size_t replay_in_flight_ = 0;
+    /// The time of the last replay of the spool
+    std::chrono::steady_clock::time_point last_replay_;
 
-    /// The Station UUID of borzoi
-    std::string borzoi_uuid_;
+    /// The prometheus metrics
+    std::unique_ptr<BorzoiSenderMetrics> metrics_;
+    std::array<std::unique_ptr<BorzoiEndpointMetrics>, kBorzoiEndpointCount> endpoint_metrics_;
 
     /// The worker thread
     std::thread worker_thread_;
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "prometheus.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+/// The class to provide prometheus metrics to the requests of one borzoi endpoint
+class BorzoiEndpointMetrics {
+  private:
+    /// The bucket boundaries of the number of packets in a request
+    inline static const prometheus::Histogram::BucketBoundaries kBatchSizeBuckets{1, 2, 5, 10, 20, 50, 100, 200};
+    /// The bucket boundaries of the time in seconds it takes to send a request
+    inline static const prometheus::Histogram::BucketBoundaries kRequestLatencyBuckets{
+        0.001, 0.002, 0.005, 0.01, 0.02, 0.05, 0.1, 0.2, 0.5, 1, 2, 5};
+
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of histograms for the number of packets in a request
+    prometheus::Family<prometheus::Histogram>& batch_size_family_;
+    /// The histogram for the number of packets in a request
+    prometheus::Histogram& batch_size_;
+    /// The family of histograms for the time it takes to send a request
+    prometheus::Family<prometheus::Histogram>& request_latency_family_;
+    /// The histogram for the time it takes to send a request
+    prometheus::Histogram& request_latency_;
+    /// The family of counters for the bytes of the request bodies
+    prometheus::Family<prometheus::Counter>& body_bytes_family_;
+    /// The counter for the bytes of the request bodies before compression
+    prometheus::Counter& body_bytes_raw_;
+    /// The counter for the bytes of the request bodies as they are sent
+    prometheus::Counter& body_bytes_sent_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    BorzoiEndpointMetrics() = delete;
+    explicit BorzoiEndpointMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter,
+                                   const std::string& endpoint)
+        : prometheus_exporter_(prometheus_exporter)
+        , batch_size_family_(prometheus_exporter_->borzoi_batch_size())
+        , batch_size_(batch_size_family_.Add({{"endpoint", endpoint}}, kBatchSizeBuckets))
+        , request_latency_family_(prometheus_exporter_->borzoi_request_latency())
+        , request_latency_(request_latency_family_.Add({{"endpoint", endpoint}}, kRequestLatencyBuckets))
+        , body_bytes_family_(prometheus_exporter_->borzoi_request_body_bytes_count())
+        , body_bytes_raw_(body_bytes_family_.Add({{"endpoint", endpoint}, {"type", "Raw"}}))
+        , body_bytes_sent_(body_bytes_family_.Add({{"endpoint", endpoint}, {"type", "Sent"}})){};
+
+    /// This function is called for every request that was sent.
+    /// \param batch_size the number of packets in the request
+    /// \param latency the time it took to send the request and receive the response
+    auto observe_request(std::size_t batch_size, std::chrono::steady_clock::duration latency) -> void {
+        batch_size_.Observe(static_cast<double>(batch_size));
+        request_latency_.Observe(std::chrono::duration<double>(latency).count());
+    }
+
+    /// This function is called for every request body that is sent.
+    /// \param raw_bytes the size of the body before compression
+    /// \param sent_bytes the size of the body as it is sent
+    auto observe_body(std::size_t raw_bytes, std::size_t sent_bytes) -> void {
+        body_bytes_raw_.Increment(static_cast<double>(raw_bytes));
+        body_bytes_sent_.Increment(static_cast<double>(sent_bytes));
+    }
+};
+
+/// The class to provide prometheus metrics to the borzoi sender
+class BorzoiSenderMetrics {
+  private:
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of gauges for the packets that wait to be sent
+    prometheus::Family<prometheus::Gauge>& backlog_family_;
+    /// The gauge for the packets that wait in the input queue of the sender
+    prometheus::Gauge& backlog_queue_;
+    /// The gauge for the packets that wait in a batch which is not yet sent
+    prometheus::Gauge& backlog_batch_;
+    /// The family of gauges for the requests that are queued or sent on the connections
+    prometheus::Family<prometheus::Gauge>& in_flight_family_;
+    /// The gauge for the requests that are queued or sent on the connections
+    prometheus::Gauge& in_flight_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    BorzoiSenderMetrics() = delete;
+    explicit BorzoiSenderMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+        : prometheus_exporter_(prometheus_exporter)
+        , backlog_family_(prometheus_exporter_->borzoi_backlog_gauge())
+        , backlog_queue_(backlog_family_.Add({{"type", "Queue"}}))
+        , backlog_batch_(backlog_family_.Add({{"type", "Batch"}}))
+        , in_flight_family_(prometheus_exporter_->borzoi_in_flight_gauge())
+        , in_flight_(in_flight_family_.Add({})){};
+
+    /// This function is called every time the sender checks its input queue.
+    /// \param queued the number of packets in the input queue
+    /// \param batched the number of packets in batches that are not yet sent
+    auto set_backlog(std::size_t queued, std::size_t batched) -> void {
+        backlog_queue_.Set(static_cast<double>(queued));
+        backlog_batch_.Set(static_cast<double>(batched));
+    }
+
+    /// This function is called every time a request is queued on or finished by a connection.
+    /// \param in_flight the number of requests that are queued or sent on the connections
+    auto set_in_flight(std::size_t in_flight) -> void { in_flight_.Set(static_cast<double>(in_flight)); }
+};
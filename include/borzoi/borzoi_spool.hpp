@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "borzoi/borzoi_endpoint.hpp"
+#include "borzoi/borzoi_wire_format.hpp"
+#include "prometheus.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// When the spool flushes written records to the disk
+enum class BorzoiSpoolSyncPolicy {
+    /// leave it to the operating system
+    kNone,
+    /// when a segment is full
+    kSegment,
+    /// after every record
+    kAlways,
+};
+
+constexpr auto to_string(BorzoiSpoolSyncPolicy policy) noexcept -> const char* {
+    switch (policy) {
+    case BorzoiSpoolSyncPolicy::kNone:
+        return "none";
+    case BorzoiSpoolSyncPolicy::kSegment:
+        return "segment";
+    case BorzoiSpoolSyncPolicy::kAlways:
+        return "always";
+    }
+};
+
+/// Parse the sync policy from its command line representation
+/// \param name the name of the policy (none, segment or always)
+/// \return the parsed sync policy
+[[nodiscard]] auto borzoi_spool_sync_policy_from_string(const std::string& name) -> BorzoiSpoolSyncPolicy;
+
+/// A packet for borzoi that is stored in the spool
+struct BorzoiSpoolRecord {
+    /// the endpoint to which the packet is sent
+    BorzoiEndpoint endpoint;
+    /// the value that selects the connection on which the packet is sent
+    uint64_t route;
+    /// the wire format of the payload
+    BorzoiWireFormat format;
+    /// the serialized packet
+    std::string payload;
+};
+
+/// The class to provide prometheus metrics to the borzoi spool
+class BorzoiSpoolMetrics {
+  private:
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of gauges for the size of the spool
+    prometheus::Family<prometheus::Gauge>& size_family_;
+    /// The gauge for the size of the spool segments on the disk in bytes
+    prometheus::Gauge& size_bytes_;
+    /// The gauge for the records in the spool that are not yet delivered
+    prometheus::Gauge& size_records_;
+    /// The family of counters for the records passing through the spool
+    prometheus::Family<prometheus::Counter>& record_count_family_;
+    /// The counter for the records that were written to the spool
+    prometheus::Counter& record_count_written_;
+    /// The counter for the records that were delivered from the spool
+    prometheus::Counter& record_count_replayed_;
+    /// The counter for the records that were dropped because of the size limit, a corrupt segment or a rejection
+    prometheus::Counter& record_count_dropped_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    BorzoiSpoolMetrics() = delete;
+    explicit BorzoiSpoolMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+        : prometheus_exporter_(prometheus_exporter)
+        , size_family_(prometheus_exporter_->borzoi_spool_size_gauge())
+        , size_bytes_(size_family_.Add({{"type", "Bytes"}}))
+        , size_records_(size_family_.Add({{"type", "Records"}}))
+        , record_count_family_(prometheus_exporter_->borzoi_spool_record_count())
+        , record_count_written_(record_count_family_.Add({{"type", "Written"}}))
+        , record_count_replayed_(record_count_family_.Add({{"type", "Replayed"}}))
+        , record_count_dropped_(record_count_family_.Add({{"type", "Dropped"}})){};
+
+    /// This function is called every time the content of the spool changes.
+    auto set_size(std::size_t bytes, std::size_t records) -> void {
+        size_bytes_.Set(static_cast<double>(bytes));
+        size_records_.Set(static_cast<double>(records));
+    }
+    /// This function is called for every record that is written to the spool.
+    auto increment_written() -> void { record_count_written_.Increment(); }
+    /// This function is called every time replayed records were delivered and removed from the spool.
+    auto increment_replayed(std::size_t records) -> void {
+        record_count_replayed_.Increment(static_cast<double>(records));
+    }
+    /// This function is called every time records are removed from the spool without being delivered.
+    auto increment_dropped(std::size_t records) -> void {
+        record_count_dropped_.Increment(static_cast<double>(records));
+    }
+};
+
+/// Durable append-only storage for packets that could not be sent to borzoi.
+/// The records are written into segment files in a directory. A new segment is started when the current one is full
+/// or when the spool is opened. Segments that were replayed completely are deleted. If the disk usage would exceed the
+/// limit, the oldest segment is dropped.
+/// Every record holds its length and a CRC32 of its content.
+/// The records are replayed from the oldest one with peek and commit. A record stays in the spool until its delivery is
+/// committed or it is dropped, therefore the records of a failed delivery can be replayed again. Segments of a
+/// previous run are replayed after a restart. The replay position is not stored, therefore packets from a partially
+/// replayed segment are sent again after a restart.
+class BorzoiSpool {
+  public:
+    BorzoiSpool() = delete;
+
+    /// Open the spool and recover the segments of a previous run.
+    /// \param directory the directory that holds the segment files. It is created if it does not exist.
+    /// \param max_bytes the maximum size of all segments on the disk. Must be at least two segments.
+    /// \param segment_bytes the size after which a new segment is started
+    /// \param sync_policy when the written records are flushed to the disk
+    /// \param prometheus_exporter the reference to the prometheus exporter that is used for the metrics of the spool
+    BorzoiSpool(std::string directory, std::size_t max_bytes, std::size_t segment_bytes,
+                BorzoiSpoolSyncPolicy sync_policy, const std::shared_ptr<PrometheusExporter>& prometheus_exporter);
+
+    ~BorzoiSpool();
+
+    /// Check the size limits of a spool. Throws if a spool cannot be opened with them.
+    /// \param max_bytes the maximum size of all segments on the disk
+    /// \param segment_bytes the size after which a new segment is started
+    static auto check_size(std::size_t max_bytes, std::size_t segment_bytes) -> void;
+
+    BorzoiSpool(const BorzoiSpool&) = delete;
+    auto operator=(const BorzoiSpool&) -> BorzoiSpool& = delete;
+    BorzoiSpool(BorzoiSpool&&) = delete;
+    auto operator=(BorzoiSpool&&) -> BorzoiSpool& = delete;
+
+    /// Append a record at the end of the spool
+    auto append(const BorzoiSpoolRecord& record) -> void;
+
+    /// Read the records that follow the peeked records without removing them from the spool. The peeked records start
+    /// at the head of the spool and are all in the oldest segment. Corrupt records at the head of the spool are
+    /// dropped. When the spool drops its oldest segment because it is full, the peeked records are forgotten.
+    /// \param max_records the maximum number of records that are read
+    /// \return the records in the order they were appended
+    [[nodiscard]] auto peek(std::size_t max_records) -> std::vector<BorzoiSpoolRecord>;
+
+    /// Remove the oldest peeked records after they were delivered. Nothing is removed if the records were dropped in
+    /// the meantime because the spool was full.
+    /// \param records the number of records that are removed
+    auto commit(std::size_t records) -> void;
+
+    /// Remove the oldest peeked records because they can never be delivered. They are counted as dropped.
+    /// \param records the number of records that are removed
+    auto drop(std::size_t records) -> void;
+
+    /// The position of the oldest record that is not committed. The position counts all records that were removed
+    /// from the spool since it was opened, so it tells which peeked records are still in the spool.
+    [[nodiscard]] auto head() -> uint64_t;
+
+    /// Check if there are records that are not yet committed
+    [[nodiscard]] auto empty() -> bool;
+
+  private:
+    /// A segment file of the spool
+    struct Segment {
+        /// the path of the segment file
+        std::string path;
+        /// the number of valid bytes in the segment file
+        std::size_t bytes = 0;
+        /// the number of records in the segment that are not yet committed
+        std::size_t records = 0;
+    };
+
+    /// Scan the segment files of a previous run and count their valid records
+    auto recover() -> void;
+
+    /// Close the current segment and start a new one
+    auto start_segment() -> void;
+
+    /// Delete the oldest segment
+    /// \return the number of records that were not committed in the segment
+    auto remove_oldest_segment() -> std::size_t;
+
+    /// Skip the records of the oldest segment that are not committed because they cannot be read
+    /// \return the number of skipped records
+    auto skip_oldest_segment() -> std::size_t;
+
+    /// Remove the oldest peeked records
+    /// \param records the number of records that are removed
+    /// \return the number of removed records
+    auto remove_peeked(std::size_t records) -> std::size_t;
+
+    /// Update the gauges of the spool
+    auto update_size_metrics() -> void;
+
+    /// The directory of the segment files
+    std::string directory_;
+    /// The maximum size of all segments on the disk
+    std::size_t max_bytes_;
+    /// The size after which a new segment is started
+    std::size_t segment_bytes_;
+    /// When the written records are flushed to the disk
+    BorzoiSpoolSyncPolicy sync_policy_;
+
+    /// The segments from the oldest to the newest. The newest segment is written if write_fd_ is open. The oldest
+    /// segment is read if read_fd_ is open.
+    std::deque<Segment> segments_;
+    /// The sequence number of the next segment
+    uint64_t next_sequence_ = 0;
+    /// The file descriptor of the newest segment
+    int write_fd_ = -1;
+    /// The file descriptor of the oldest segment
+    int read_fd_ = -1;
+    /// The position of the oldest record in the oldest segment that is not committed
+    std::size_t read_offset_ = 0;
+    /// The sizes of the peeked records, starting at the read offset
+    std::deque<std::size_t> peeked_sizes_;
+    /// The position after the last peeked record in the oldest segment
+    std::size_t peek_offset_ = 0;
+
+    /// The size of all segments on the disk
+    std::size_t total_bytes_ = 0;
+    /// The number of records that are not yet committed
+    std::size_t total_records_ = 0;
+    /// The number of records that were committed or dropped since the spool was opened
+    uint64_t removed_records_ = 0;
+
+    /// The mutex for all members of the spool
+    std::mutex mutex_;
+
+    /// The prometheus metrics
+    std::unique_ptr<BorzoiSpoolMetrics> metrics_;
+};
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <nlohmann/json_fwd.hpp>
+#include <string>
+#include <vector>
+
+/// The encoding of the packets that are sent to borzoi
+enum class BorzoiWireFormat {
+    /// text json
+    kJson,
+    /// RFC 8949 Concise Binary Object Representation
+    kCbor,
+    /// MessagePack
+    kMessagePack,
+};
+
+constexpr auto to_string(BorzoiWireFormat format) noexcept -> const char* {
+    switch (format) {
+    case BorzoiWireFormat::kJson:
+        return "json";
+    case BorzoiWireFormat::kCbor:
+        return "cbor";
+    case BorzoiWireFormat::kMessagePack:
+        return "msgpack";
+    }
+};
+
+/// The value of the Content-Type header of requests in the wire format
+constexpr auto content_type(BorzoiWireFormat format) noexcept -> const char* {
+    switch (format) {
+    case BorzoiWireFormat::kJson:
+        return "application/json";
+    case BorzoiWireFormat::kCbor:
+        return "application/cbor";
+    case BorzoiWireFormat::kMessagePack:
+        return "application/msgpack";
+    }
+};
+
+/// Parse the wire format from its command line representation
+/// \param name the name of the wire format (json, cbor or msgpack)
+/// \return the parsed wire format
+[[nodiscard]] auto borzoi_wire_format_from_string(const std::string& name) -> BorzoiWireFormat;
+
+/// Serialize a packet for borzoi
+/// \param json the packet
+/// \param format the wire format
+/// \return the bytes of the serialized packet
+[[nodiscard]] auto serialize_borzoi_packet(const nlohmann::json& json, BorzoiWireFormat format) -> std::string;
+
+/// Deserialize a packet for borzoi
+/// \param payload the bytes of the serialized packet
+/// \param format the wire format of the payload
+/// \return the packet
+[[nodiscard]] auto deserialize_borzoi_packet(const std::string& payload, BorzoiWireFormat format) -> nlohmann::json;
+
+/// Combine serialized packets into an array without parsing them again
+/// \param packets the bytes of the serialized packets
+/// \param format the wire format of the packets
+/// \return the bytes of the array
+[[nodiscard]] auto serialize_borzoi_batch(const std::vector<std::string>& packets, BorzoiWireFormat format)
+    -> std::string;
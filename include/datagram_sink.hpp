@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "output/output_sink_queue.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+/// Sends every packet as one json datagram to a local consumer. The json text is created once by the output fan-out
+/// and sent without copying it. The destination is either a UDP port on localhost
+/// (<port>), a UDP host and port (<host>:<port>) or a Unix datagram socket (unix:<path>).
+/// The datagrams are sent without blocking. If nobody is listening or the receive buffer of the consumer is full, the
+/// datagram is dropped.
+class DatagramSink {
+  public:
+    DatagramSink() = delete;
+
+    /// Create the socket, connect it to the destination and start the thread sending the datagrams
+    /// \param destination the destination of the datagrams
+    /// \param queue the queue of this sink in the output fan-out
+    /// \param termination_flag this flag is set when the sink should terminate after sending all packets
+    DatagramSink(const std::string& destination, std::shared_ptr<OutputSinkQueue> queue,
+                 std::atomic_bool& termination_flag);
+
+    ~DatagramSink();
+
+    /// Check that the destination can be parsed and resolved. Throws otherwise. This allows to report an invalid
+    /// command line option before any thread is started.
+    /// \param destination the destination of the datagrams
+    static auto check_destination(const std::string& destination) -> void;
+
+    DatagramSink(const DatagramSink&) = delete;
+    auto operator=(const DatagramSink&) -> DatagramSink& = delete;
+    DatagramSink(DatagramSink&&) = delete;
+    auto operator=(DatagramSink&&) -> DatagramSink& = delete;
+
+  private:
+    /// The thread function for continously sending the packets from the queue
+    auto worker() -> void;
+
+    /// Send a serialized packet as one datagram
+    /// \param json_text the serialized packet
+    /// \return true if the datagram was sent
+    auto send(const std::string& json_text) -> bool;
+
+    /// Connect the Unix datagram socket to its path again, e.g. after the consumer was restarted
+    auto reconnect_unix() -> bool;
+
+    /// The socket connected to the destination
+    int fd_ = -1;
+
+    /// The path of the Unix datagram socket or empty for UDP
+    std::string unix_path_;
+
+    /// The input queue
+    std::shared_ptr<OutputSinkQueue> queue_;
+
+    /// The flag that is set when terminating the program
+    std::atomic_bool& termination_flag_;
+
+    /// The worker thread
+    std::thread worker_thread_;
+};
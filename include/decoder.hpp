@@ -11,11 +11,16 @@
 
 #include "bit_stream_decoder.hpp"
 #include "borzoi/borzoi_sender.hpp"
+#include "datagram_sink.hpp"
 #include "iq_stream_decoder.hpp"
 #include "l2/lower_mac.hpp"
 #include "l2/upper_mac.hpp"
+#include "output/output_fan_out.hpp"
 #include "thread_safe_fifo.hpp"
+#include "utils/iq_format.hpp"
+#include <array>
 #include <atomic>
+#include <complex>
 #include <memory>
 #include <optional>
 #include <string>
@@ -40,8 +45,10 @@
  */
 class Decoder {
   public:
-    Decoder(unsigned int receive_port, const std::string& borzoi_url, const std::string& borzoi_uuid, bool packed,
-            std::optional<std::string> input_file, std::optional<std::string> output_file, bool iq_or_bit_stream,
+    Decoder(unsigned int receive_port, const std::optional<std::string>& transmit_destination,
+            std::size_t transmit_queue_capacity, const std::string& borzoi_url, const std::string& borzoi_uuid,
+            const BorzoiSenderOptions& borzoi_sender_options, bool packed, std::optional<std::string> input_file,
+            std::optional<std::string> output_file, bool iq_or_bit_stream, IQFormat iq_format,
             std::optional<unsigned int> uplink_scrambling_code,
             const std::shared_ptr<PrometheusExporter>& prometheus_exporter);
     ~Decoder();
@@ -56,10 +63,13 @@ class Decoder {
     /// This flag is passed for the StreamingOrderedOutputThreadPoolExecutor to the upper mac.
     std::atomic_bool upper_mac_termination_flag_ = false;
 
-    /// This flag is passed from the upper mac to the borzoi sender.
-    std::atomic_bool borzoi_sender_termination_flag_ = false;
-    /// This queue is used to pass data from the upper mac to the borzoi sender.
-    ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>> bozoi_queue_;
+    /// This flag is passed from the upper mac to the output fan-out.
+    std::atomic_bool output_fan_out_termination_flag_ = false;
+    /// This queue is used to pass data from the upper mac to the output fan-out.
+    ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>> output_queue_;
+
+    /// This flag is passed from the output fan-out to the sinks.
+    std::atomic_bool output_sink_termination_flag_ = false;
 
     /// The worker queue for the lower mac
     std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>> lower_mac_work_queue_;
@@ -70,6 +80,13 @@ class Decoder {
     /// The reference to the borzoi sender thread class
     std::unique_ptr<BorzoiSender> borzoi_sender_;
 
+    /// The reference to the thread class sending json datagrams, if enabled
+    std::unique_ptr<DatagramSink> datagram_sink_;
+
+    /// The reference to the output fan-out thread class. It is declared after the sinks, because it has to be
+    /// destructed before them.
+    std::unique_ptr<OutputFanOut> output_fan_out_;
+
     std::shared_ptr<BitStreamDecoder> bit_stream_decoder_;
     std::unique_ptr<IQStreamDecoder> iq_stream_decoder_;
 
@@ -88,6 +105,13 @@ class Decoder {
     // bit stream -> false
     bool iq_or_bit_stream_;
 
+    /// The sample format of the received IQ stream
+    IQFormat iq_format_;
+
     // 64KB receive buffer.
     static const std::size_t kRX_BUFFER_SIZE = 64 * 1024;
+
+    /// The buffer that holds the received IQ samples converted to complex floats. It is sized for the most compact
+    /// format (cs8, 2 bytes per sample).
+    std::array<std::complex<float>, kRX_BUFFER_SIZE / bytes_per_sample(IQFormat::kComplexInt8)> iq_samples_{};
 };
@@ -11,10 +11,14 @@
 
 #include "bit_stream_decoder.hpp"
 #include "fixed_queue.hpp"
+#include "iq_stream_decoder_metrics.hpp"
+#include "utils/burst_peak_picker.hpp"
 #include "l2/lower_mac.hpp"
 #include "streaming_ordered_output_thread_pool_executor.hpp"
+#include <array>
 #include <complex>
 #include <memory>
+#include <vector>
 
 /**
  * Tetra downlink decoder for PI/4-DQPSK modulation
@@ -26,42 +30,148 @@ class IQStreamDecoder {
     IQStreamDecoder(
         const std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>>& lower_mac_worker_queue,
         const std::shared_ptr<LowerMac>& lower_mac, const std::shared_ptr<BitStreamDecoder>& bit_stream_decoder,
-        bool is_uplink);
+        bool is_uplink, const std::shared_ptr<PrometheusExporter>& prometheus_exporter);
     ~IQStreamDecoder() = default;
 
+    /// Process a block of received symbols. The tracked phase offset is removed from the symbols before they are
+    /// passed to the burst detection.
+    /// \param symbols the received symbols
+    /// \param count the number of received symbols
+    void process_complex(const std::complex<float>* symbols, std::size_t count) noexcept;
+
     void process_complex(std::complex<float> symbol) noexcept;
 
-  private:
+    /// Pass the last detected uplink burst to the lower mac at the end of the stream
+    void flush() { uplink_burst_peak_picker_.flush(); };
+
     using QueueT = FixedQueue<std::complex<float>, 300>;
 
+    // 9.4.4.3.2 Normal training sequence
+    static inline const std::vector<std::complex<float>> kNormalTrainingSequence1 = {
+        {-1, -1}, {-1, 1}, {1, 1}, {1, 1}, {-1, -1}, {1, -1}, {1, -1}, {-1, 1}, {-1, -1}, {-1, 1}, {1, 1}};
+    static inline const std::vector<std::complex<float>> kNormalTrainingSequence2 = {
+        {-1, 1}, {-1, -1}, {1, -1}, {1, -1}, {-1, 1}, {1, 1}, {1, 1}, {-1, -1}, {-1, 1}, {-1, -1}, {1, -1}};
+    // 9.4.4.3.3 Extended training sequence
+    static inline const std::vector<std::complex<float>> kExtendedTrainingSequence = {
+        {1, -1}, {-1, 1}, {-1, -1}, {-1, 1}, {1, 1}, {1, 1}, {-1, -1}, {1, -1},
+        {1, -1}, {-1, 1}, {-1, -1}, {-1, 1}, {1, 1}, {1, 1}, {-1, -1}};
+
+    // An uplink burst is detected when its training sequence starts at the training sequence offset of the symbol
+    // buffer. The burst starts at the beginning of the symbol buffer and is trained at the same offset.
+    // 9.4.2.1 Control uplink burst: 2 tail + 42 coded symbols + 15 training symbols + 42 coded symbols + 2 tail
+    static constexpr std::size_t kControlUplinkBurstLength = 103;
+    static constexpr std::size_t kControlUplinkBurstTrainingSeqOffset = 44;
+    // 9.4.2.2 Normal uplink burst: 2 tail + 108 coded symbols + 11 training symbols + 108 coded symbols + 2 tail
+    static constexpr std::size_t kNormalUplinkBurstLength = 231;
+    static constexpr std::size_t kNormalUplinkBurstTrainingSeqOffset = 110;
+
+    /// Correlate the symbols at an offset of the symbol buffer with a training sequence
+    /// \param symbols the symbol buffer
+    /// \param training_seq_offset the position of the first training symbol in the symbol buffer
+    /// \param training_seq the known symbols of the training sequence
+    /// \return the absolute value of the correlation
+    static auto training_seq_correlation(const QueueT& symbols, std::size_t training_seq_offset,
+                                         const std::vector<std::complex<float>>& training_seq) -> float;
+
+    /// The number of taps of the linear equalizer that is trained on the training sequence of each uplink burst
+    static constexpr std::size_t kEqualizerTaps = 3;
+    using EqualizerTaps = std::array<std::complex<float>, kEqualizerTaps>;
+
+    /// Estimate the channel of a burst from its training sequence. The least-squares solution of a linear equalizer
+    /// that maps the received symbols around the training sequence onto the known training symbols is returned. This
+    /// compensates gain, phase and short multipath of the burst.
+    /// \param burst the received symbols of the burst
+    /// \param training_seq the known symbols of the training sequence
+    /// \param training_seq_offset the position of the first training symbol in the burst
+    /// \return the taps of the equalizer
+    static auto channel_estimation(const std::vector<std::complex<float>>& burst,
+                                   const std::vector<std::complex<float>>& training_seq,
+                                   std::size_t training_seq_offset) -> EqualizerTaps;
+
+    /// Apply the equalizer to all symbols of a burst
+    /// \param burst the received symbols of the burst
+    /// \param taps the taps of the equalizer
+    /// \return the equalized symbols of the burst
+    static auto equalize(const std::vector<std::complex<float>>& burst, const EqualizerTaps& taps)
+        -> std::vector<std::complex<float>>;
+
+  private:
     static std::complex<float> hard_decision(std::complex<float> const& symbol);
 
     template <class iterator_type> static void symbols_to_bitstream(iterator_type it, uint8_t* bits, std::size_t len);
 
-    static void abs_convolve_same_length(const QueueT& queueA, std::size_t offsetA, const std::complex<float>* itb,
-                                         std::size_t len, float* res);
+    /// Estimate the residual phase offset of a burst from its training sequence
+    /// \param burst the received symbols of the burst
+    /// \param training_seq the known symbols of the training sequence
+    /// \param training_seq_offset the position of the first training symbol in the burst
+    /// \return the phase offset of the burst in radians
+    static auto estimate_phase_offset(const std::vector<std::complex<float>>& burst,
+                                      const std::vector<std::complex<float>>& training_seq,
+                                      std::size_t training_seq_offset) noexcept -> float;
 
-    std::vector<std::complex<float>> channel_estimation(std::vector<std::complex<float>> const& stream,
-                                                        std::vector<std::complex<float>> const& pilots);
+    /// Estimate the residual phase offset of a block of symbols without knowledge of the transmitted symbols. The
+    /// fourth power of the symbols removes the modulation. The estimate is ambiguous by multiples of pi/2.
+    /// \param symbols the received symbols
+    /// \param count the number of received symbols
+    /// \return the phase offset of the symbols in radians
+    auto estimate_phase_offset_blind(const std::complex<float>* symbols, std::size_t count) -> float;
+
+    /// Update the tracked phase offset with a new estimate of the residual phase offset
+    /// \param residual_phase_offset the residual phase offset in radians
+    void update_phase_offset(float residual_phase_offset) noexcept;
+
+    /// An uplink burst detected in the symbol stream
+    struct UplinkBurst {
+        BurstType burst_type;
+        /// the received symbols of the burst
+        std::vector<std::complex<float>> symbols;
+    };
+
+    /// Pass a detection of an uplink burst at the start of the symbol buffer to the peak picker if its correlation is
+    /// above the detection threshold
+    /// \param burst_type the type of the detected burst
+    /// \param len the length of the burst in symbols
+    /// \param correlation the absolute correlation of the hard decisions with the training sequence
+    /// \param training_seq_length the length of the training sequence in symbols
+    void detect_uplink_burst(BurstType burst_type, std::size_t len, float correlation, std::size_t training_seq_length);
+
+    /// Equalize an uplink burst and pass it to the lower mac
+    /// \param burst the uplink burst
+    void process_uplink_burst(UplinkBurst&& burst);
 
     QueueT symbol_buffer_;
     QueueT symbol_buffer_hard_decision_;
 
-    // 9.4.4.3.2 Normal training sequence
-    const std::vector<std::complex<float>> training_seq_n_ = {{-1, -1}, {-1, 1}, {1, 1},   {1, 1},  {-1, -1}, {1, -1},
-                                                              {1, -1},  {-1, 1}, {-1, -1}, {-1, 1}, {1, 1}};
-    std::vector<std::complex<float>> training_seq_n_reversed_conj_{};
-    const std::vector<std::complex<float>> training_seq_p_ = {{-1.0, 1.0}, {-1.0, -1.0}, {1.0, -1.0}, {1.0, -1.0},
-                                                              {-1.0, 1.0}, {1.0, 1.0},   {1.0, 1.0},  {-1.0, -1.0},
-                                                              {-1.0, 1.0}, {-1.0, -1.0}, {1.0, -1.0}};
-    std::vector<std::complex<float>> training_seq_p_reversed_conj_{};
-    // 9.4.4.3.3 Extended training sequence
-    const std::vector<std::complex<float>> training_seq_x_ = {
-        {1.0, -1.0}, {-1.0, 1.0}, {-1.0, -1.0}, {-1.0, 1.0}, {1.0, 1.0}, {1.0, 1.0}, {-1.0, -1.0}, {1.0, -1.0},
-        {1.0, -1.0}, {-1.0, 1.0}, {-1.0, -1.0}, {-1.0, 1.0}, {1.0, 1.0}, {1.0, 1.0}, {-1.0, -1.0}};
-    std::vector<std::complex<float>> training_seq_x_reversed_conj_{};
+    /// The minimum correlation of the hard decisions with the training sequence relative to a perfect match at which an
+    /// uplink burst is detected
+    static constexpr float kUplinkBurstDetectionThreshold = 0.7F;
+
+    /// Diagonal loading of the equalizer normal equations relative to the average received power. This keeps the
+    /// solution stable for bursts with little energy or an ill-conditioned training sequence.
+    static constexpr float kEqualizerDiagonalLoading = 1e-3F;
+
+    /// The symbol rate of TETRA in symbols per second
+    static constexpr float kSymbolRate = 18000;
+    /// The gain of the first order loop that tracks the phase offset
+    static constexpr float kPhaseOffsetLoopGain = 0.1F;
+
+    /// The tracked phase offset in radians. The received symbols are differentially demodulated, therefore a carrier
+    /// frequency offset of f Hz shows up as a constant rotation of 2 * pi * f / kSymbolRate on every symbol.
+    float phase_offset_ = 0;
+
+    /// The buffer for the received symbols after the tracked phase offset was removed
+    std::vector<std::complex<float>> derotated_symbols_;
+    /// The scratch buffer for the blind phase offset estimation
+    std::vector<std::complex<float>> fourth_power_symbols_;
+
+    /// The maximum distance in symbols of uplink burst detections that belong to the same burst
+    static constexpr std::size_t kUplinkBurstPeakWindow = 16;
+    /// The number of received symbols on the uplink
+    std::size_t uplink_symbol_position_ = 0;
+    /// Select the best detection out of adjacent detections of the same uplink burst
+    BurstPeakPicker<UplinkBurst> uplink_burst_peak_picker_;
 
-    const float SEQUENCE_DETECTION_THRESHOLD = 1.5;
+    std::unique_ptr<IQStreamDecoderMetrics> metrics_;
 
     std::shared_ptr<LowerMac> lower_mac_{};
     std::shared_ptr<BitStreamDecoder> bit_stream_decoder_{};
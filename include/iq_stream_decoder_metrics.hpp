@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "prometheus.h"
+#include <memory>
+
+/// The class to provide prometheus metrics to the iq stream decoder
+class IQStreamDecoderMetrics {
+  private:
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of gauges for the carrier frequency offset
+    prometheus::Family<prometheus::Gauge>& frequency_offset_family_;
+    /// The gauge for the tracked carrier frequency offset that is corrected on the received symbols
+    prometheus::Gauge& tracked_frequency_offset_;
+    /// The gauge for the residual carrier frequency offset of the last estimate
+    prometheus::Gauge& residual_frequency_offset_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    IQStreamDecoderMetrics() = delete;
+    explicit IQStreamDecoderMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+        : prometheus_exporter_(prometheus_exporter)
+        , frequency_offset_family_(prometheus_exporter_->iq_frequency_offset_gauge())
+        , tracked_frequency_offset_(frequency_offset_family_.Add({{"type", "Tracked"}}))
+        , residual_frequency_offset_(frequency_offset_family_.Add({{"type", "Residual"}})){};
+
+    /// This function is called every time the frequency offset is estimated.
+    /// \param tracked the tracked frequency offset in Hz after the estimate was applied
+    /// \param residual the residual frequency offset in Hz of the estimate
+    auto set_frequency_offset(const double tracked, const double residual) -> void {
+        tracked_frequency_offset_.Set(tracked);
+        residual_frequency_offset_.Set(residual);
+    }
+};
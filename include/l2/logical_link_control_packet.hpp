@@ -69,7 +69,7 @@ struct LogicalLinkControlPacket : public UpperMacCPlaneSignallingPacket {
 
     LogicalLinkControlPacket() = default;
 
-    explicit LogicalLinkControlPacket(const UpperMacCPlaneSignallingPacket& packet);
+    explicit LogicalLinkControlPacket(UpperMacCPlaneSignallingPacket&& packet);
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(LogicalLinkControlPacket, burst_type_, logical_channel_, type_, encrypted_, address_,
                                    fragmentation_, fragmentation_on_stealling_channel_, reservation_requirement_,
@@ -10,6 +10,7 @@
 
 #include "burst_type.hpp"
 #include "l2/logical_channel.hpp"
+#include "l2/timebase_counter.hpp"
 #include <cassert>
 #include <set>
 #include <vector>
@@ -114,6 +115,8 @@ class Slots {
   private:
     /// which burst type ths slots originated from
     BurstType burst_type_{};
+    /// the network time of the burst ths slots originated from
+    TimebaseCounter time_{};
     /// the number and types of slots
     SlotType slot_type_{};
     /// The slots, either one half or full slot or two half slots.
@@ -127,10 +130,10 @@ class Slots {
     Slots(const Slots& other) = default;
 
     /// constructor for one subslot or a full slot
-    Slots(BurstType burst_type, SlotType slot_type, Slot&& slot);
+    Slots(BurstType burst_type, TimebaseCounter time, SlotType slot_type, Slot&& slot);
 
     /// construct for two half slot
-    Slots(BurstType burst_type, SlotType slot_type, Slot&& first_slot, Slot&& second_slot);
+    Slots(BurstType burst_type, TimebaseCounter time, SlotType slot_type, Slot&& first_slot, Slot&& second_slot);
 
     /// get a reference to the concreate slots
     [[nodiscard]] auto get_concreate_slots() const -> std::vector<ConcreateSlot> {
@@ -169,6 +172,9 @@ class Slots {
     /// get the type of the underlying burst
     [[nodiscard]] auto get_burst_type() const noexcept -> BurstType { return burst_type_; }
 
+    /// get the network time of the underlying burst
+    [[nodiscard]] auto get_time() const noexcept -> TimebaseCounter { return time_; }
+
     /// get the type of the underlying slot
     [[nodiscard]] auto get_slot_type() const noexcept -> SlotType { return slot_type_; }
 
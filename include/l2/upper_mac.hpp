@@ -18,9 +18,15 @@
 #include "prometheus.h"
 #include "streaming_ordered_output_thread_pool_executor.hpp"
 #include "thread_safe_fifo.hpp"
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <future>
 #include <memory>
 #include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
 
 class UpperMac {
   public:
@@ -40,17 +46,76 @@ class UpperMac {
     ~UpperMac();
 
   private:
-    /// The thread function for continously process incomming packets for the lower MAC and passing it into the upper
-    /// layers.
+    /// The slots of one burst and the packets that were parsed from them
+    struct ParsedSlots {
+        Slots slots;
+        UpperMacPackets packets;
+    };
+
+    /// The slots of one burst and the c-plane packets after the fragment reconstruction
+    struct ReassembledSlots {
+        Slots slots;
+        std::vector<UpperMacCPlaneSignallingPacket> c_plane_packets;
+        /// set if there was an error in the fragment reconstruction
+        bool decode_error = false;
+    };
+
+    /// The number of timeslots in a TDMA frame. The fragments of the c-plane packets are reconstructed per timeslot.
+    static constexpr std::size_t kTimeslotCount = 4;
+
+    /// The fragment reconstruction of one timeslot. It runs on its own thread and only sees the slots of its timeslot.
+    struct ReassemblyShard {
+        std::unique_ptr<UpperMacDownlinkFragmentation> downlink_fragmentation;
+        std::unique_ptr<UpperMacUplinkFragmentation> uplink_fragmentation;
+        /// The parsed slots of this timeslot and the promise for the reconstructed packets
+        ThreadSafeFifo<std::pair<ParsedSlots, std::promise<ReassembledSlots>>> input_queue;
+        std::thread thread;
+    };
+
+    /// The parsed packets or the failed slots of one burst in the order they are inserted into the output queue
+    using OutputElements = std::vector<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>;
+
+    /// The number of worker threads that parse slots and the number of worker threads that parse reconstructed packets
+    /// in the upper layers
+    static constexpr auto kParserWorkerCount = 4;
+
+    /// The thread function for continously passing the incomming slots from the lower MAC to the slot parser workers.
     auto worker() -> void;
 
-    /// process the slots from the lower MAC
+    /// The thread function for distributing the parsed slots to the reassembly shard of their timeslot. For every burst
+    /// the parsing of the upper layers is queued in the order of the slots, so the output stays in order independent of
+    /// the timeslot.
+    auto reassembly_worker() -> void;
+
+    /// The thread function of a reassembly shard. The fragment reconstruction is executed sequentially for the slots of
+    /// one timeslot, as it keeps state between the slots.
+    /// \param shard the reassembly shard of the timeslot
+    auto reassembly_shard_worker(ReassemblyShard& shard) -> void;
+
+    /// The thread function for passing the parsed packets into the output queue in the order of the slots.
+    auto output_worker() -> void;
+
+    /// Parse the slots from the lower MAC. This function does not keep state and is executed on the slot parser
+    /// workers.
     /// \param slots the slots from the lower MAC
-    auto process(const Slots& slots) -> void;
+    /// \return the slots and the packets parsed from them
+    auto parse_slots(const Slots& slots) -> ParsedSlots;
+
+    /// Perform the fragment reconstruction on the packets of one burst
+    /// \param shard the reassembly shard of the timeslot of the burst
+    /// \param parsed_slots the slots and the packets that were parsed from them
+    /// \return the slots and the reconstructed c-plane packets
+    auto reassemble(ReassemblyShard& shard, ParsedSlots&& parsed_slots) -> ReassembledSlots;
 
-    /// process Upper MAC packets and perform fragment reconstruction and pass it to the upper layers
-    /// \param packets the packets that were parsed in the upper MAC layer
-    auto processPackets(UpperMacPackets&& packets) -> void;
+    /// Parse the reconstructed packets in the upper layers. This function is executed on the packet parser workers.
+    /// \param reassembled_slots the slots and the reconstructed c-plane packets
+    /// \return the parsed packets or the failed slots
+    auto parse_packets(ReassembledSlots&& reassembled_slots) -> OutputElements;
+
+    /// Report the decoding error in all slots of the burst
+    /// \param slots the slots in which the decoding failed
+    /// \return the failed slots for the output queue
+    auto decode_error(const Slots& slots) -> OutputElements;
 
     /// The input queue
     std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>> input_queue_;
@@ -70,11 +135,32 @@ class UpperMac {
     std::shared_ptr<UpperMacFragmentsPrometheusCounters> fragmentation_metrics_uplink_continous_;
     std::shared_ptr<UpperMacFragmentsPrometheusCounters> fragmentation_metrics_downlink_stealing_channel_;
 
+    /// The parser for the upper layers. It does not keep state, so it is shared between the packet parser workers.
     LogicalLinkControlParser logical_link_control_;
 
-    std::unique_ptr<UpperMacDownlinkFragmentation> downlink_fragmentation_;
-    std::unique_ptr<UpperMacUplinkFragmentation> uplink_fragmentation_;
+    /// The fragment reconstruction state of each timeslot
+    std::array<ReassemblyShard, kTimeslotCount> reassembly_shards_;
+
+    /// The termination flag on the input of the slot parser workers
+    std::atomic_bool slot_parser_termination_flag_ = false;
+    /// The termination flag on the input of the reassembly worker
+    std::atomic_bool reassembly_termination_flag_ = false;
+    /// The termination flag on the input of the reassembly shards
+    std::atomic_bool reassembly_shard_termination_flag_ = false;
+    /// The termination flag on the input of the packet parser workers
+    std::atomic_bool packet_parser_termination_flag_ = false;
+    /// The termination flag on the input of the output worker
+    std::atomic_bool output_worker_termination_flag_ = false;
+
+    /// The workers that parse the slots
+    std::unique_ptr<StreamingOrderedOutputThreadPoolExecutor<ParsedSlots>> slot_parser_;
+    /// The workers that parse the reconstructed packets in the upper layers
+    std::unique_ptr<StreamingOrderedOutputThreadPoolExecutor<OutputElements>> packet_parser_;
 
     /// The worker thread
     std::thread worker_thread_;
+    /// The reassembly thread
+    std::thread reassembly_thread_;
+    /// The output thread
+    std::thread output_thread_;
 };
\ No newline at end of file
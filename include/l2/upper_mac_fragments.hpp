@@ -11,11 +11,15 @@
 #include "l2/upper_mac_packet.hpp"
 #include "prometheus.h"
 #include "utils/address.hpp"
+#include "utils/bit_vector.hpp"
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <list>
 #include <memory>
 #include <optional>
-#include <set>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 class UpperMacFragmentsPrometheusCounters {
@@ -32,6 +36,17 @@ class UpperMacFragmentsPrometheusCounters {
     /// The counter for received fragments that could not be reassembled
     prometheus::Counter& fragment_count_error_;
 
+    /// The family of gauges for the packets that are currently being reassembled
+    prometheus::Family<prometheus::Gauge>& reassembly_live_family_;
+    /// The gauge for the packets that are currently being reassembled
+    prometheus::Gauge& reassembly_live_;
+    /// The family of counters for abandoned reassemblies
+    prometheus::Family<prometheus::Counter>& reassembly_evicted_family_;
+    /// The counter for reassemblies that did not make progress in time
+    prometheus::Counter& reassembly_evicted_timeout_;
+    /// The counter for reassemblies that were dropped because too many were in progress
+    prometheus::Counter& reassembly_evicted_capacity_;
+
     // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
 
   public:
@@ -42,86 +57,168 @@ class UpperMacFragmentsPrometheusCounters {
         , fragment_count_family_(prometheus_exporter_->upper_mac_fragment_count())
         , fragment_count_total_(fragment_count_family_.Add({{"type", type}, {"counter_type", "All"}}))
         , fragment_count_error_(
-              fragment_count_family_.Add({{"type", type}, {"counter_type", "Reconstuction Error"}})){};
+              fragment_count_family_.Add({{"type", type}, {"counter_type", "Reconstuction Error"}}))
+        , reassembly_live_family_(prometheus_exporter_->upper_mac_fragment_reassembly_live())
+        , reassembly_live_(reassembly_live_family_.Add({{"type", type}}))
+        , reassembly_evicted_family_(prometheus_exporter_->upper_mac_fragment_reassembly_evicted_count())
+        , reassembly_evicted_timeout_(reassembly_evicted_family_.Add({{"type", type}, {"reason", "Timeout"}}))
+        , reassembly_evicted_capacity_(reassembly_evicted_family_.Add({{"type", type}, {"reason", "Capacity"}})){};
 
     /// This function is called for every fragment where no fitting previous fragment could be found.
     auto increment_fragment_reconstruction_error() -> void { fragment_count_error_.Increment(); }
     /// This function is called for every fragment.
     auto increment_fragment_count() -> void { fragment_count_total_.Increment(); }
+    /// This function is called when the reassembly of a packet is started.
+    auto increment_live_reassemblies() -> void { reassembly_live_.Increment(); }
+    /// This function is called when the reassembly of a packet is finished or abandoned.
+    auto decrement_live_reassemblies() -> void { reassembly_live_.Decrement(); }
+    /// This function is called for every reassembly that did not make progress in time.
+    auto increment_evicted_by_timeout() -> void { reassembly_evicted_timeout_.Increment(); }
+    /// This function is called for every reassembly that was dropped because too many were in progress.
+    auto increment_evicted_by_capacity() -> void { reassembly_evicted_capacity_.Increment(); }
 };
 
-/// Class that provides the fragment reconstruction for downlink packets.
-class UpperMacDownlinkFragmentation {
-  private:
-    /// Holds the internal state of the fragment rebuilder
-    enum class State {
-        kStart,
-        kStartFragmentReceived,
-        kContinuationFragmentReceived,
-        kEndFragmentReceived,
+/// Holds the internal state of the fragment rebuilder
+enum class UpperMacFragmentationState {
+    kStart,
+    kStartFragmentReceived,
+    kContinuationFragmentReceived,
+    kEndFragmentReceived,
+};
+
+/// The table of allowed state changes of the fragment rebuilder. It is indexed by the current and the new state.
+using UpperMacFragmentationTransitionTable = std::array<std::array<bool, 4>, 4>;
+
+/// Create the table of allowed state changes of the fragment rebuilder at compile time
+/// \param continuation_fragments_allowed are an arbitrary number of continuation fragments allowed
+/// \return the table of allowed state changes
+constexpr auto make_upper_mac_fragmentation_transition_table(bool continuation_fragments_allowed)
+    -> UpperMacFragmentationTransitionTable {
+    using State = UpperMacFragmentationState;
+    UpperMacFragmentationTransitionTable table{};
+    auto allow = [&table](State from, State to) {
+        table[static_cast<std::size_t>(from)][static_cast<std::size_t>(to)] = true;
     };
-    /// The vector that holds the accumulated fragments
-    std::vector<UpperMacCPlaneSignallingPacket> fragments_;
-    /// Are continuation allowed in the state machine?
-    std::map<State, std::set<State>> allowed_state_changes_;
+
+    allow(State::kStart, State::kStartFragmentReceived);
+    allow(State::kStartFragmentReceived, State::kEndFragmentReceived);
+    allow(State::kEndFragmentReceived, State::kStart);
+    if (continuation_fragments_allowed) {
+        allow(State::kStartFragmentReceived, State::kContinuationFragmentReceived);
+        allow(State::kContinuationFragmentReceived, State::kContinuationFragmentReceived);
+        allow(State::kContinuationFragmentReceived, State::kEndFragmentReceived);
+    }
+
+    return table;
+};
+
+/// The allowed state changes if an arbitrary number of continuation fragments are allowed
+constexpr UpperMacFragmentationTransitionTable kUpperMacFragmentationWithContinuation =
+    make_upper_mac_fragmentation_transition_table(/*continuation_fragments_allowed=*/true);
+/// The allowed state changes if only a start and an end fragment are allowed
+constexpr UpperMacFragmentationTransitionTable kUpperMacFragmentationWithoutContinuation =
+    make_upper_mac_fragmentation_transition_table(/*continuation_fragments_allowed=*/false);
+
+/// The state machine and the accumulated fragments of one fragmented packet.
+/// The payloads of the fragments are kept as a chain of BitVectors that share their buffers with the received bursts.
+/// The TM-SDU of the reconstructed packet is only materialized once when the end fragment is received.
+class UpperMacFragmentReassembly {
+  private:
+    /// The allowed state changes
+    const UpperMacFragmentationTransitionTable* transitions_;
     /// The current state of the fragment reassembler
-    State state_;
+    UpperMacFragmentationState state_ = UpperMacFragmentationState::kStart;
+    /// The start fragment. Its header is used for the reconstructed packet.
+    std::optional<UpperMacCPlaneSignallingPacket> start_fragment_;
+    /// The TM-SDUs of the accumulated fragments
+    std::vector<BitVector> segments_;
+
+    /// Drop all accumulated fragments
+    auto reset() -> void {
+        start_fragment_.reset();
+        segments_.clear();
+        state_ = UpperMacFragmentationState::kStart;
+    };
 
-    /// the metrics for the fragmentation
-    std::shared_ptr<UpperMacFragmentsPrometheusCounters> metrics_;
+    /// Save a fragment in the chain
+    auto add_fragment(UpperMacFragmentationState new_state, const UpperMacCPlaneSignallingPacket& fragment) -> void {
+        if (new_state == UpperMacFragmentationState::kStartFragmentReceived) {
+            start_fragment_ = fragment;
+        }
+        segments_.emplace_back(*fragment.tm_sdu_);
+        state_ = new_state;
+    };
+
+  public:
+    UpperMacFragmentReassembly() = delete;
+
+    /// \param transitions the allowed state changes, must outlive this object
+    explicit UpperMacFragmentReassembly(const UpperMacFragmentationTransitionTable& transitions)
+        : transitions_(&transitions){};
+
+    /// Check if we are in the start state i.e., do no have any fragments.
+    [[nodiscard]] auto is_in_start_state() const noexcept -> bool {
+        return state_ == UpperMacFragmentationState::kStart;
+    };
 
     /// Try the state transtition with a fragment. Increment the error metrics if there is an invalid state transition
     /// attempted
     /// \param new_state the new state into which the state machine would be transfered with this fragment
     /// \param fragment the control plane signalling packet that is fragmented
+    /// \param metrics the metrics for the fragmentation, may be null
     /// \return an optional reconstructed control plane signalling packet when reconstuction was successful
-    auto change_state(State new_state, const UpperMacCPlaneSignallingPacket& fragment)
-        -> std::optional<UpperMacCPlaneSignallingPacket> {
-        const auto& valid_state_changes = allowed_state_changes_[state_];
-
+    auto change_state(UpperMacFragmentationState new_state, const UpperMacCPlaneSignallingPacket& fragment,
+                      UpperMacFragmentsPrometheusCounters* metrics) -> std::optional<UpperMacCPlaneSignallingPacket> {
         // increment the total fragment counters
-        if (metrics_) {
-            metrics_->increment_fragment_count();
+        if (metrics) {
+            metrics->increment_fragment_count();
         }
 
-        if (valid_state_changes.count(new_state)) {
+        if ((*transitions_)[static_cast<std::size_t>(state_)][static_cast<std::size_t>(new_state)]) {
             // valid state change. perform and add fragment
-            fragments_.emplace_back(fragment);
-            state_ = new_state;
+            add_fragment(new_state, fragment);
         } else {
             // increment the invalid state metrics
-            if (metrics_) {
-                metrics_->increment_fragment_reconstruction_error();
+            if (metrics) {
+                metrics->increment_fragment_reconstruction_error();
             }
 
+            reset();
             // always save the start segment
-            if (new_state == State::kStartFragmentReceived) {
-                fragments_ = {fragment};
-                state_ = State::kStartFragmentReceived;
-            } else {
-                fragments_.clear();
-                state_ = State::kStart;
+            if (new_state == UpperMacFragmentationState::kStartFragmentReceived) {
+                add_fragment(new_state, fragment);
             }
         }
 
         // if we are in the end state reassmeble the packet.
-        if (state_ == State::kEndFragmentReceived) {
-            std::optional<UpperMacCPlaneSignallingPacket> packet;
-            for (const auto& fragment : fragments_) {
-                if (packet) {
-                    packet->tm_sdu_->append(*fragment.tm_sdu_);
-                } else {
-                    packet = fragment;
-                }
-            }
-            fragments_.clear();
-            state_ = State::kStart;
+        if (state_ == UpperMacFragmentationState::kEndFragmentReceived) {
+            auto packet = std::move(start_fragment_);
+            packet->tm_sdu_ = BitVector::concatenate(segments_);
+            reset();
 
             return packet;
         }
 
         return std::nullopt;
     };
+};
+
+/// Class that provides the fragment reconstruction for downlink packets.
+class UpperMacDownlinkFragmentation {
+  private:
+    using State = UpperMacFragmentationState;
+
+    /// The state machine and the accumulated fragments
+    UpperMacFragmentReassembly reassembly_;
+
+    /// the metrics for the fragmentation
+    std::shared_ptr<UpperMacFragmentsPrometheusCounters> metrics_;
+
+    /// Try the state transtition with a fragment.
+    auto change_state(State new_state, const UpperMacCPlaneSignallingPacket& fragment)
+        -> std::optional<UpperMacCPlaneSignallingPacket> {
+        return reassembly_.change_state(new_state, fragment, metrics_.get());
+    };
 
   public:
     UpperMacDownlinkFragmentation() = delete;
@@ -130,26 +227,14 @@ class UpperMacDownlinkFragmentation {
     /// allowed
     explicit UpperMacDownlinkFragmentation(const std::shared_ptr<UpperMacFragmentsPrometheusCounters>& metrics,
                                            bool continuation_fragments_allowed = true)
-        : state_(State::kStart)
-        , metrics_(metrics) {
-        if (continuation_fragments_allowed) {
-            allowed_state_changes_ = {
-                {State::kStart, {State::kStartFragmentReceived}},
-                {State::kStartFragmentReceived, {State::kContinuationFragmentReceived, State::kEndFragmentReceived}},
-                {State::kContinuationFragmentReceived,
-                 {State::kContinuationFragmentReceived, State::kEndFragmentReceived}},
-                {State::kEndFragmentReceived, {State::kStart}}};
-        } else {
-            allowed_state_changes_ = {{State::kStart, {State::kStartFragmentReceived}},
-                                      {State::kStartFragmentReceived, {State::kEndFragmentReceived}},
-                                      {State::kEndFragmentReceived, {State::kStart}}};
-        }
-    };
+        : reassembly_(continuation_fragments_allowed ? kUpperMacFragmentationWithContinuation
+                                                     : kUpperMacFragmentationWithoutContinuation)
+        , metrics_(metrics){};
 
     /// Check if we are in the start state i.e., do no have any fragments.
-    auto is_in_start_state() -> bool { return state_ == State::kStart; }
+    auto is_in_start_state() -> bool { return reassembly_.is_in_start_state(); }
 
-    /// Push a fragment for reconstruction.
+    /// Push a fragment for reconstruction. Throws if the packet is not a downlink fragment.
     /// \param fragment the control plane signalling packet that is fragmented
     /// \return an optional reconstructed control plane signalling packet when reconstuction was successful
     auto push_fragment(const UpperMacCPlaneSignallingPacket& fragment)
@@ -187,97 +272,149 @@ class UpperMacDownlinkFragmentation {
 /// Class that provides the fragment reconstruction for uplink packets.
 /// Uplink fragmentation may include reserved slots and is therefore harder to reconstruct. This is not handled
 /// with this class.
+/// Only the mobile stations with a reassembly in progress are stored. A reassembly is evicted if no fragment was
+/// received for a number of uplink bursts or if the maximum number of reassemblies in progress is reached.
+/// The network time of the uplink does not advance, therefore the age of a reassembly is measured in the bursts that
+/// were passed to this store.
 class UpperMacUplinkFragmentation {
+  public:
+    /// The default number of uplink bursts without a fragment after which a reassembly is evicted, i.e., the four
+    /// timeslots of one multiframe
+    static constexpr std::size_t kDefaultMaxAgeBursts = 18 * 4;
+    /// The default maximum number of reassemblies in progress
+    static constexpr std::size_t kDefaultMaxEntries = 1024;
+
   private:
-    /// Holds the internal state of the fragment rebuilder
-    enum class State {
-        kStart,
-        kStartFragmentReceived,
-        kContinuationFragmentReceived,
-        kEndFragmentReceived,
+    using State = UpperMacFragmentationState;
+
+    /// The reassembly of a mobile station, the burst in which it last received a fragment and its position in the
+    /// order of the last received fragments
+    struct Entry {
+        UpperMacFragmentReassembly reassembly;
+        std::size_t last_burst;
+        std::list<AddressKey>::iterator order_position;
     };
-    /// The vector that holds the accumulated fragments for each mobile station by its address
-    std::map<Address, std::vector<UpperMacCPlaneSignallingPacket>> fragments_per_address_;
-    /// Are continuation allowed in the state machine?
-    std::map<State, std::set<State>> allowed_state_changes_;
-    /// The current state of the fragment reassembler for each mobile station by its address
-    std::map<Address, State> state_per_address_;
 
-    /// the metrics for the fragmentation
-    std::shared_ptr<UpperMacFragmentsPrometheusCounters> metrics_;
+    /// The reassemblies in progress for each mobile station by its address
+    std::unordered_map<AddressKey, Entry> entries_;
+    /// The addresses of the reassemblies in progress. The reassembly that received its last fragment the longest time
+    /// ago is at the front.
+    std::list<AddressKey> order_;
 
-    /// Try the state transtition with a fragment. Increment the error metrics if there is an invalid state transition
-    /// attempted
-    /// \param new_state the new state into which the state machine would be transfered with this fragment
-    /// \param fragment the control plane signalling packet that is fragmented
-    /// \return an optional reconstructed control plane signalling packet when reconstuction was successful
-    auto change_state(State new_state, const UpperMacCPlaneSignallingPacket& fragment)
-        -> std::optional<UpperMacCPlaneSignallingPacket> {
-        const auto& address = fragment.address_;
-        auto& state = state_per_address_[address];
-        auto& fragments = fragments_per_address_[address];
+    /// The number of uplink bursts without a fragment after which a reassembly is evicted
+    std::size_t max_age_bursts_;
+    /// The maximum number of reassemblies in progress
+    std::size_t max_entries_;
+    /// The number of bursts that were passed to this store
+    std::size_t burst_count_ = 0;
 
-        const auto& valid_state_changes = allowed_state_changes_[state];
+    /// the metrics for the fragmentation
+    std::shared_ptr<UpperMacFragmentsPrometheusCounters> metrics_;
 
-        // increment the total fragment counters
+    /// Remove an entry and update the metrics
+    auto erase(std::unordered_map<AddressKey, Entry>::iterator it) -> void {
         if (metrics_) {
-            metrics_->increment_fragment_count();
+            metrics_->decrement_live_reassemblies();
         }
+        order_.erase(it->second.order_position);
+        entries_.erase(it);
+    };
 
-        if (valid_state_changes.count(new_state)) {
-            // valid state change. perform and add fragment
-            fragments.emplace_back(fragment);
-            state = new_state;
-        } else {
-            // increment the invalid state metrics
+    /// Evict all reassemblies that did not receive a fragment in time
+    auto evict_old_entries() -> void {
+        while (!order_.empty()) {
+            auto oldest = entries_.find(order_.front());
+            if (burst_count_ - oldest->second.last_burst <= max_age_bursts_) {
+                break;
+            }
             if (metrics_) {
-                metrics_->increment_fragment_reconstruction_error();
+                metrics_->increment_evicted_by_timeout();
             }
+            erase(oldest);
+        }
+    };
 
-            // always save the start segment
-            if (new_state == State::kStartFragmentReceived) {
-                fragments = {fragment};
-                state = State::kStartFragmentReceived;
-            } else {
-                fragments.clear();
-                state = State::kStart;
-            }
+    /// Evict the reassembly that received its last fragment the longest time ago
+    auto evict_oldest_entry() -> void {
+        if (order_.empty()) {
+            return;
         }
+        if (metrics_) {
+            metrics_->increment_evicted_by_capacity();
+        }
+        erase(entries_.find(order_.front()));
+    };
 
-        // if we are in the end state reassmeble the packet.
-        if (state == State::kEndFragmentReceived) {
-            std::optional<UpperMacCPlaneSignallingPacket> packet;
-            for (const auto& fragment : fragments) {
-                if (packet) {
-                    packet->tm_sdu_->append(*fragment.tm_sdu_);
-                } else {
-                    packet = fragment;
+    /// Try the state transtition with a fragment of the mobile station that sent it.
+    auto change_state(State new_state, const UpperMacCPlaneSignallingPacket& fragment)
+        -> std::optional<UpperMacCPlaneSignallingPacket> {
+        const auto key = fragment.address_.key();
+        auto it = entries_.find(key);
+        if (it == entries_.end()) {
+            // Only the start fragment begins a reassembly. Other fragments without a start are errors.
+            if (new_state != State::kStartFragmentReceived) {
+                if (metrics_) {
+                    metrics_->increment_fragment_count();
+                    metrics_->increment_fragment_reconstruction_error();
                 }
+                return std::nullopt;
             }
-            fragments.clear();
-            state = State::kStart;
+            if (entries_.size() >= max_entries_) {
+                evict_oldest_entry();
+            }
+            it = entries_
+                     .emplace(key,
+                              Entry{.reassembly = UpperMacFragmentReassembly(kUpperMacFragmentationWithContinuation),
+                                    .last_burst = burst_count_,
+                                    .order_position = order_.insert(order_.end(), key)})
+                     .first;
+            if (metrics_) {
+                metrics_->increment_live_reassemblies();
+            }
+        }
 
-            return packet;
+        auto& entry = it->second;
+        entry.last_burst = burst_count_;
+        order_.splice(order_.end(), order_, entry.order_position);
+        auto packet = entry.reassembly.change_state(new_state, fragment, metrics_.get());
+
+        // Only keep the entries of mobile stations with a reassembly in progress
+        if (entry.reassembly.is_in_start_state()) {
+            erase(it);
         }
 
-        return std::nullopt;
+        return packet;
     };
 
   public:
     UpperMacUplinkFragmentation() = delete;
 
-    /// Constructor for the fragmentations. Optionally specify if an arbitraty numner of continuation fragments are
-    /// allowed
-    explicit UpperMacUplinkFragmentation(const std::shared_ptr<UpperMacFragmentsPrometheusCounters>& metrics)
-        : metrics_(metrics) {
-        allowed_state_changes_ = {
-            {State::kStart, {State::kStartFragmentReceived}},
-            {State::kStartFragmentReceived, {State::kContinuationFragmentReceived, State::kEndFragmentReceived}},
-            {State::kContinuationFragmentReceived, {State::kContinuationFragmentReceived, State::kEndFragmentReceived}},
-            {State::kEndFragmentReceived, {State::kStart}}};
+    /// Constructor for the fragmentations.
+    /// \param metrics the metrics for the fragmentation, may be null
+    /// \param max_age_bursts the number of uplink bursts without a fragment after which a reassembly is evicted
+    /// \param max_entries the maximum number of reassemblies in progress
+    explicit UpperMacUplinkFragmentation(const std::shared_ptr<UpperMacFragmentsPrometheusCounters>& metrics,
+                                         std::size_t max_age_bursts = kDefaultMaxAgeBursts,
+                                         std::size_t max_entries = kDefaultMaxEntries)
+        : max_age_bursts_(max_age_bursts)
+        , max_entries_(max_entries)
+        , metrics_(metrics) {
+        if (max_entries_ == 0) {
+            throw std::runtime_error("At least one uplink reassembly must be allowed");
+        }
     };
 
-    /// Push a fragment for reconstruction.
+    /// The number of reassemblies in progress
+    [[nodiscard]] auto size() const noexcept -> std::size_t { return entries_.size(); };
+
+    /// Start the next burst. This must be called once for every burst before its fragments are pushed. The
+    /// reassemblies that did not receive a fragment in the last max_age_bursts bursts are evicted.
+    auto next_burst() -> void {
+        burst_count_++;
+        evict_old_entries();
+    };
+
+    /// Push a fragment of the current burst for reconstruction. Throws if the packet is not an uplink fragment.
     /// \param fragment the control plane signalling packet that is fragmented
     /// \return an optional reconstructed control plane signalling packet when reconstuction was successful
     auto push_fragment(const UpperMacCPlaneSignallingPacket& fragment)
@@ -300,8 +437,13 @@ class UpperMacUplinkFragmentation {
         case MacPacketType::kMacFragmentUplink:
             return change_state(State::kContinuationFragmentReceived, fragment);
         case MacPacketType::kMacEndHu:
-            throw std::runtime_error("MacEndHu is in a reserverd subslot and not handled since there is no "
-                                     "integration between the uplink and downlink processing");
+            // MacEndHu is in a reserverd subslot and not handled since there is no integration between the uplink and
+            // downlink processing. It is counted as a fragment that could not be reassembled.
+            if (metrics_) {
+                metrics_->increment_fragment_count();
+                metrics_->increment_fragment_reconstruction_error();
+            }
+            return std::nullopt;
         case MacPacketType::kMacEndUplink:
             return change_state(State::kEndFragmentReceived, fragment);
         case MacPacketType::kMacUBlck:
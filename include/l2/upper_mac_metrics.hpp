@@ -14,8 +14,12 @@
 #include "l2/upper_mac_packet_builder.hpp"
 #include "prometheus.h"
 #include "utils/packet_counter_metrics.hpp"
+#include "utils/parse_result.hpp"
+#include <cstddef>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 /// The class to provide prometheus metrics to the upper mac.
 /// 1. Received Slot are counted. Details about the number of Slot with CRC errors and decoding errors are saved.
@@ -63,8 +67,62 @@ class UpperMacMetrics {
     /// The counter for received StealingChannel with decoding errors
     prometheus::Counter& stealing_channel_received_count_decoding_error_;
 
+    /// The family of counters for the categories of parse errors
+    prometheus::Family<prometheus::Counter>& parse_error_count_family_;
+
     // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
 
+    /// The counter for each parse error category
+    std::vector<prometheus::Counter*> parse_error_counters_;
+
+    /// The index of the upper mac packet counters
+    enum UpperMacPacketType : std::size_t { kCPlaneSignalling, kUPlaneSignalling, kUPlaneTraffic, kBroadcast };
+
+    /// The names of the upper mac packet counters in the order of UpperMacPacketType
+    static auto upper_mac_packet_type_names() -> std::vector<std::string> {
+        return {"C-Plane Signalling", "U-Plane Signalling", "U-Plane Traffic", "Broadcast"};
+    }
+
+    /// The index of the c-plane signalling packet counters
+    enum CPlaneSignallingPacketType : std::size_t {
+        kMacResource,
+        kMacResourceFragments,
+        kMacResourceNullPdu,
+        kMacFragmentDownlink,
+        kMacEndDownlink,
+        kMacDBlck,
+        kMacAccess,
+        kMacAccessFragments,
+        kMacAccessNullPdu,
+        kMacEndHu,
+        kMacData,
+        kMacDataFragments,
+        kMacDataNullPdu,
+        kMacFragmentUplink,
+        kMacEndUplink,
+        kMacUBlck,
+    };
+
+    /// The names of the c-plane signalling packet counters in the order of CPlaneSignallingPacketType
+    static auto c_plane_signalling_packet_type_names() -> std::vector<std::string> {
+        return {"MacResource",
+                "MacResource fragments",
+                "MacResource null pdu",
+                "MacFragmentDownlink",
+                "MacEndDownlink",
+                "MacDBlck",
+                "MacAccess",
+                "MacAccess fragments",
+                "MacAccess null pdu",
+                "MacEndHu",
+                "MacData",
+                "MacData fragments",
+                "MacData null pdu",
+                "MacFragmentUplink",
+                "MacEndUplink",
+                "MacUBlck"};
+    }
+
     /// the class for the upper mac packet counters
     PacketCounterMetrics upper_mac_packet_metrics_;
 
@@ -101,8 +159,15 @@ class UpperMacMetrics {
               {{"logical_channel", "SignallingChannelFull"}, {"error_type", "Decode Error"}}))
         , stealing_channel_received_count_decoding_error_(
               slot_error_count_family_.Add({{"logical_channel", "StealingChannel"}, {"error_type", "Decode Error"}}))
-        , upper_mac_packet_metrics_(prometheus_exporter_, "upper_mac")
-        , c_plane_signalling_packet_metrics_(prometheus_exporter_, "c_plane_signalling"){};
+        , parse_error_count_family_(prometheus_exporter_->upper_mac_parse_error_count())
+        , upper_mac_packet_metrics_(prometheus_exporter_, "upper_mac", upper_mac_packet_type_names())
+        , c_plane_signalling_packet_metrics_(prometheus_exporter_, "c_plane_signalling",
+                                             c_plane_signalling_packet_type_names()) {
+        for (std::size_t category = 0; category < kParseErrorCategoryCount; category++) {
+            parse_error_counters_.push_back(
+                &parse_error_count_family_.Add({{"category", to_string(ParseErrorCategory(category))}}));
+        }
+    };
 
     /// This function is called for every slot once it is passed up from the lower MAC
     /// \param slot the content of the slot
@@ -166,16 +231,24 @@ class UpperMacMetrics {
         }
     }
 
+    /// This function is called for every slot that failed to parse in the upper mac
+    /// \param slot the content of the slot
+    /// \param error the error that was found while parsing the slot
+    auto increment_parse_error(const ConcreateSlot& slot, const ParseError& error) -> void {
+        increment_decode_error(slot);
+        parse_error_counters_.at(static_cast<std::size_t>(error.category))->Increment();
+    }
+
     /// This function is called for all decoded packets in the upper mac
     /// \param packets the datastructure that contains all the successfully decoded packets
     auto increment_packet_counters(const UpperMacPackets& packets) -> void {
-        upper_mac_packet_metrics_.increment("C-Plane Signalling", packets.c_plane_signalling_packets_.size());
-        upper_mac_packet_metrics_.increment("U-Plane Signalling", packets.u_plane_signalling_packet_.size());
+        upper_mac_packet_metrics_.increment(kCPlaneSignalling, packets.c_plane_signalling_packets_.size());
+        upper_mac_packet_metrics_.increment(kUPlaneSignalling, packets.u_plane_signalling_packet_.size());
         if (packets.u_plane_traffic_packet_) {
-            upper_mac_packet_metrics_.increment("U-Plane Traffic");
+            upper_mac_packet_metrics_.increment(kUPlaneTraffic);
         }
         if (packets.broadcast_packet_) {
-            upper_mac_packet_metrics_.increment("Broadcast");
+            upper_mac_packet_metrics_.increment(kBroadcast);
         }
     }
 
@@ -185,52 +258,53 @@ class UpperMacMetrics {
         switch (packet.type_) {
         case MacPacketType::kMacResource:
             if (packet.is_downlink_fragment()) {
-                c_plane_signalling_packet_metrics_.increment("MacResource fragments");
+                c_plane_signalling_packet_metrics_.increment(kMacResourceFragments);
             } else if (packet.is_null_pdu()) {
-                c_plane_signalling_packet_metrics_.increment("MacResource null pdu");
+                c_plane_signalling_packet_metrics_.increment(kMacResourceNullPdu);
             } else {
-                c_plane_signalling_packet_metrics_.increment("MacResource");
+                c_plane_signalling_packet_metrics_.increment(kMacResource);
             }
             break;
         case MacPacketType::kMacFragmentDownlink:
-            c_plane_signalling_packet_metrics_.increment("MacFragmentDownlink");
+            c_plane_signalling_packet_metrics_.increment(kMacFragmentDownlink);
             break;
         case MacPacketType::kMacEndDownlink:
-            c_plane_signalling_packet_metrics_.increment("MacEndDownlink");
+            c_plane_signalling_packet_metrics_.increment(kMacEndDownlink);
             break;
         case MacPacketType::kMacDBlck:
-            c_plane_signalling_packet_metrics_.increment("MacDBlck");
+            c_plane_signalling_packet_metrics_.increment(kMacDBlck);
+            break;
         case MacPacketType::kMacBroadcast:
             throw std::runtime_error("C-Plane signalling may not be of type MacBroadcast");
         case MacPacketType::kMacAccess:
             if (packet.is_uplink_fragment()) {
-                c_plane_signalling_packet_metrics_.increment("MacAccess fragments");
+                c_plane_signalling_packet_metrics_.increment(kMacAccessFragments);
             } else if (packet.is_null_pdu()) {
-                c_plane_signalling_packet_metrics_.increment("MacAccess null pdu");
+                c_plane_signalling_packet_metrics_.increment(kMacAccessNullPdu);
             } else {
-                c_plane_signalling_packet_metrics_.increment("MacAccess");
+                c_plane_signalling_packet_metrics_.increment(kMacAccess);
             }
             break;
         case MacPacketType::kMacEndHu:
-            c_plane_signalling_packet_metrics_.increment("MacEndHu");
+            c_plane_signalling_packet_metrics_.increment(kMacEndHu);
             break;
         case MacPacketType::kMacData:
             if (packet.is_uplink_fragment()) {
-                c_plane_signalling_packet_metrics_.increment("MacData fragments");
+                c_plane_signalling_packet_metrics_.increment(kMacDataFragments);
             } else if (packet.is_null_pdu()) {
-                c_plane_signalling_packet_metrics_.increment("MacData null pdu");
+                c_plane_signalling_packet_metrics_.increment(kMacDataNullPdu);
             } else {
-                c_plane_signalling_packet_metrics_.increment("MacData");
+                c_plane_signalling_packet_metrics_.increment(kMacData);
             }
             break;
         case MacPacketType::kMacFragmentUplink:
-            c_plane_signalling_packet_metrics_.increment("MacFragmentUplink");
+            c_plane_signalling_packet_metrics_.increment(kMacFragmentUplink);
             break;
         case MacPacketType::kMacEndUplink:
-            c_plane_signalling_packet_metrics_.increment("MacEndUplink");
+            c_plane_signalling_packet_metrics_.increment(kMacEndUplink);
             break;
         case MacPacketType::kMacUBlck:
-            c_plane_signalling_packet_metrics_.increment("MacUBlck");
+            c_plane_signalling_packet_metrics_.increment(kMacUBlck);
             break;
         case MacPacketType::kMacUSignal:
             throw std::runtime_error("C-Plane signalling may not be of type MacUSignal");
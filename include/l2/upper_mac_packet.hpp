@@ -476,6 +476,9 @@ struct UpperMacCPlaneSignallingPacket {
 
     UpperMacCPlaneSignallingPacket() = default;
     UpperMacCPlaneSignallingPacket(const UpperMacCPlaneSignallingPacket&) = default;
+    UpperMacCPlaneSignallingPacket(UpperMacCPlaneSignallingPacket&&) = default;
+    auto operator=(const UpperMacCPlaneSignallingPacket&) -> UpperMacCPlaneSignallingPacket& = default;
+    auto operator=(UpperMacCPlaneSignallingPacket&&) -> UpperMacCPlaneSignallingPacket& = default;
     UpperMacCPlaneSignallingPacket(BurstType burst_type, LogicalChannel logical_channel, MacPacketType type)
         : burst_type_(burst_type)
         , logical_channel_(logical_channel)
@@ -11,6 +11,7 @@
 #include "l2/slot.hpp"
 #include "l2/upper_mac_packet.hpp"
 #include "utils/bit_vector.hpp"
+#include "utils/parse_result.hpp"
 #include <cstddef>
 #include <optional>
 #include <stdexcept>
@@ -31,13 +32,23 @@ struct UpperMacPackets {
     /// slots.
     /// \param other the UpperMacPackets which should be merged into the current one
     auto merge(UpperMacPackets&& other) -> void {
+        if (auto error = try_merge(std::move(other))) {
+            throw std::runtime_error(error->message);
+        }
+    }
+
+    /// Merge two extracted UpperMacPackets into one without throwing.
+    /// \param other the UpperMacPackets which should be merged into the current one
+    /// \return the error if both contain a packet of which only one may exist per burst
+    [[nodiscard]] auto try_merge(UpperMacPackets&& other) -> std::optional<ParseError> {
         std::move(other.c_plane_signalling_packets_.begin(), other.c_plane_signalling_packets_.end(),
                   std::back_inserter(c_plane_signalling_packets_));
         std::move(other.u_plane_signalling_packet_.begin(), other.u_plane_signalling_packet_.end(),
                   std::back_inserter(u_plane_signalling_packet_));
 
         if (u_plane_traffic_packet_ && other.u_plane_traffic_packet_) {
-            throw std::runtime_error("Trying to merge two packets both with a UpperMacUPlaneTrafficPacket");
+            return ParseError{ParseErrorCategory::kNotAllowed,
+                              "Trying to merge two packets both with a UpperMacUPlaneTrafficPacket"};
         }
 
         if (other.u_plane_traffic_packet_) {
@@ -45,12 +56,15 @@ struct UpperMacPackets {
         }
 
         if (broadcast_packet_ && other.broadcast_packet_) {
-            throw std::runtime_error("Trying to merge two packets both with a UpperMacBroadcastPacket");
+            return ParseError{ParseErrorCategory::kNotAllowed,
+                              "Trying to merge two packets both with a UpperMacBroadcastPacket"};
         }
 
         if (other.broadcast_packet_) {
             broadcast_packet_ = std::move(*other.broadcast_packet_);
         }
+
+        return std::nullopt;
     }
 
     /// Distribute the information of the uplink c-plane signalling null pdu to all other c-plane signalling packets.
@@ -106,39 +120,43 @@ class UpperMacPacketBuilder {
     /// \param preprocessing_bit_count the number of bits int he BitVector before parsing the MAC PDU
     /// \param fill_bit_indication true if there are fill bits indicated
     /// \param length the length in bits of the payload if it is not defined implicitly
-    /// \return the TM-SDU as a BitVector
+    /// \return the TM-SDU as a BitVector or the error if the length indication is invalid
     [[nodiscard]] static auto extract_tm_sdu(BitVector& data, std::size_t preprocessing_bit_count,
                                              unsigned _BitInt(1) fill_bit_indication,
-                                             std::optional<std::size_t> length = std::nullopt) -> BitVector;
+                                             std::optional<std::size_t> length = std::nullopt)
+        -> ParseResult<BitVector>;
 
     /// Parse the broadcast packet contained in a BitVector
     /// \param channel the logical channel on which the broadcast packet is sent
     /// \param data the BitVector which holds the MAC broadcast packet
-    /// \return the parsed broadcast packet
-    [[nodiscard]] static auto parse_broadcast(LogicalChannel channel, BitVector&& data) -> UpperMacBroadcastPacket;
+    /// \return the parsed broadcast packet or the parse error
+    [[nodiscard]] static auto parse_broadcast(LogicalChannel channel, BitVector&& data)
+        -> ParseResult<UpperMacBroadcastPacket>;
 
     /// Parse a control plane signalling packet (singular) contained in a BitVector
     /// \param burst_type which burst was used to send this packet
     /// \param channel the logical channel on which the packets are sent
     /// \param data the BitVector which holds the packet
-    /// \return the parsed c-plane signalling packet
+    /// \return the parsed c-plane signalling packet or the parse error. Truncation is not checked, as it is recorded in
+    /// the BitVector.
     [[nodiscard]] static auto parse_c_plane_signalling_packet(BurstType burst_type, LogicalChannel channel,
-                                                              BitVector& data) -> UpperMacCPlaneSignallingPacket;
+                                                              BitVector& data)
+        -> ParseResult<UpperMacCPlaneSignallingPacket>;
 
     /// Parse the control plane signalling packets contained in a BitVector
     /// \param burst_type which burst was used to send these packets
     /// \param channel the logical channel on which the packets are sent
     /// \param data the BitVector which holds the packets
-    /// \return the parsed c-plane signalling packets
+    /// \return the parsed c-plane signalling packets or the parse error
     [[nodiscard]] static auto parse_c_plane_signalling(BurstType burst_type, LogicalChannel channel, BitVector&& data)
-        -> std::vector<UpperMacCPlaneSignallingPacket>;
+        -> ParseResult<std::vector<UpperMacCPlaneSignallingPacket>>;
 
     /// Parse the user plane signalling packet contained in a BitVector
     /// \param channel the logical channel on which the packet is sent
     /// \param data the BitVector which holds the packet
-    /// \return the parsed u-plane signalling packet
+    /// \return the parsed u-plane signalling packet or the parse error
     [[nodiscard]] static auto parse_u_plane_signalling(LogicalChannel channel, BitVector&& data)
-        -> UpperMacUPlaneSignallingPacket;
+        -> ParseResult<UpperMacUPlaneSignallingPacket>;
 
     /// Parse the user plane traffic packet contained in a BitVector
     /// \param channel the logical channel on which the packet is sent
@@ -154,5 +172,13 @@ class UpperMacPacketBuilder {
     /// \param burst_type which burst was used to send this slot
     /// \param slot the data passed from the lower mac for this slot
     /// \return the extracted packets
+    /// \throws std::runtime_error if the slot contains a malformed or truncated PDU
     [[nodiscard]] static auto parse_slot(const ConcreateSlot& slot) -> UpperMacPackets;
+
+    /// Parse a slot (singular) and extract all the contained packets without throwing on malformed or truncated PDUs.
+    /// Only the MAC PDUs are parsed without exceptions. The TM-SDUs of the packets throw again when they are parsed by
+    /// the LLC and the layers above, which report malformed PDUs with exceptions.
+    /// \param slot the data passed from the lower mac for this slot
+    /// \return the extracted packets or the first error that was found
+    [[nodiscard]] static auto try_parse_slot(const ConcreateSlot& slot) -> ParseResult<UpperMacPackets>;
 };
\ No newline at end of file
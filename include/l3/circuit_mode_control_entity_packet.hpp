@@ -316,7 +316,7 @@ struct CircuitModeControlEntityPacket : public MobileLinkEntityPacket {
 
     CircuitModeControlEntityPacket() = default;
 
-    explicit CircuitModeControlEntityPacket(const MobileLinkEntityPacket& packet);
+    explicit CircuitModeControlEntityPacket(MobileLinkEntityPacket&& packet);
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(CircuitModeControlEntityPacket, burst_type_, logical_channel_, type_, encrypted_,
                                    address_, fragmentation_, fragmentation_on_stealling_channel_,
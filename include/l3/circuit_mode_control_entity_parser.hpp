@@ -15,22 +15,37 @@ class CircuitModeControlEntityParser : public PacketParser<MobileLinkEntityPacke
   public:
     CircuitModeControlEntityParser() = delete;
     explicit CircuitModeControlEntityParser(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
-        : PacketParser(prometheus_exporter, "circuit_mode_control_entity")
+        : PacketParser(prometheus_exporter, "circuit_mode_control_entity", packet_type_names())
         , sds_(prometheus_exporter){};
 
   private:
-    [[nodiscard]] auto packet_name(const CircuitModeControlEntityPacket& packet) const -> std::string override {
-        return to_string(packet.packet_type_);
+    /// The names of the downlink CMCE PDUs followed by the names of the uplink CMCE PDUs
+    static auto packet_type_names() -> std::vector<std::string> {
+        std::vector<std::string> names;
+        for (auto i = 0; i < kPduCount; i++) {
+            names.emplace_back(to_string(CircuitModeControlEntityDownlinkPacketType(i)));
+        }
+        for (auto i = 0; i < kPduCount; i++) {
+            names.emplace_back(to_string(CircuitModeControlEntityUplinkPacketType(i)));
+        }
+        return names;
     };
 
-    auto forward(const CircuitModeControlEntityPacket& packet)
-        -> std::unique_ptr<CircuitModeControlEntityPacket> override {
+    [[nodiscard]] auto packet_type(const CircuitModeControlEntityPacket& packet) const -> std::size_t override {
+        const auto pdu_type = std::visit([](auto&& arg) { return static_cast<std::size_t>(arg); }, packet.packet_type_);
+        return packet.packet_type_.index() * kPduCount + pdu_type;
+    };
+
+    auto forward(CircuitModeControlEntityPacket&& packet) -> std::unique_ptr<CircuitModeControlEntityPacket> override {
         if (packet.sds_data_) {
-            return sds_.parse(packet);
+            return sds_.parse(std::move(packet));
         }
 
-        return std::make_unique<CircuitModeControlEntityPacket>(packet);
+        return std::make_unique<CircuitModeControlEntityPacket>(std::move(packet));
     };
 
     ShortDataServiceParser sds_;
+
+    /// The number of CMCE PDU types in one direction
+    static const auto kPduCount = 32;
 };
\ No newline at end of file
@@ -50,7 +50,7 @@ struct MobileLinkEntityPacket : public LogicalLinkControlPacket {
 
     MobileLinkEntityPacket() = default;
 
-    explicit MobileLinkEntityPacket(const LogicalLinkControlPacket& packet);
+    explicit MobileLinkEntityPacket(LogicalLinkControlPacket&& packet);
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(MobileLinkEntityPacket, burst_type_, logical_channel_, type_, encrypted_, address_,
                                    fragmentation_, fragmentation_on_stealling_channel_, reservation_requirement_,
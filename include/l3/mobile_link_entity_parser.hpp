@@ -17,54 +17,55 @@ class MobileLinkEntityParser : public PacketParser<LogicalLinkControlPacket, Mob
   public:
     MobileLinkEntityParser() = delete;
     explicit MobileLinkEntityParser(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
-        : PacketParser(prometheus_exporter, "mobile_link_entity")
+        : PacketParser(prometheus_exporter, "mobile_link_entity", packet_type_names())
         , cmce_(prometheus_exporter)
-        , mm_(prometheus_exporter) {
-        downlink_mle_pdu_description_ = {
-            "D-NEW-CELL",    "D-PREPARE-FAIL", "D-NWRK-BROADCAST",   "D-NWRK-BROADCAST EXTENSION",
-            "D-RESTORE-ACK", "D-RESTORE-FAIL", "D-CHANNEL RESPONSE", "Extended PDU"};
-        downlink_mle_pdu_extension_description_ = {"D-NWRK-BROADCAST-DA", "D-NWRK-BROADCAST REMOVE",
-                                                   "D-Reserved2",         "D-Reserved3",
-                                                   "D-Reserved4",         "D-Reserved5",
-                                                   "D-Reserved6",         "D-Reserved7",
-                                                   "D-Reserved8",         "D-Reserved9",
-                                                   "D-Reserved10",        "D-Reserved11",
-                                                   "D-Reserved12",        "D-Reserved13",
-                                                   "D-Reserved14",        "D-Reserved15"};
-        uplink_mle_pdu_description_ = {
-            "U-PREPARE", "U-PREPARE-DA", "U-IRREGULAR CHANNEL ADVICE", "U-CHANNEL CLASS ADVICE",
-            "U-RESTORE", "Reserved",     "U-CHANNEL REQUEST",          "Extended PDU"};
-        uplink_mle_pdu_extension_description_ = {"U-Reserved0",  "U-Reserved1",  "U-Reserved2",  "U-Reserved3",
-                                                 "U-Reserved4",  "U-Reserved5",  "U-Reserved6",  "U-Reserved7",
-                                                 "U-Reserved8",  "U-Reserved9",  "U-Reserved10", "U-Reserved11",
-                                                 "U-Reserved12", "U-Reserved13", "U-Reserved14", "U-Reserved15"};
-    };
+        , mm_(prometheus_exporter){};
 
   private:
-    [[nodiscard]] auto packet_name(const MobileLinkEntityPacket& packet) const -> std::string override {
+    /// The names of the MLE protocols, followed by the downlink MLE PDUs, the downlink MLE extension PDUs, the uplink
+    /// MLE PDUs and the uplink MLE extension PDUs
+    static auto packet_type_names() -> std::vector<std::string> {
+        std::vector<std::string> names;
+        for (auto i = 0; i < kMleProtocolCount; i++) {
+            names.emplace_back(to_string(MobileLinkEntityProtocolDiscriminator(i)));
+        }
+        names.insert(names.end(), {"D-NEW-CELL", "D-PREPARE-FAIL", "D-NWRK-BROADCAST", "D-NWRK-BROADCAST EXTENSION",
+                                   "D-RESTORE-ACK", "D-RESTORE-FAIL", "D-CHANNEL RESPONSE", "Extended PDU"});
+        names.insert(names.end(), {"D-NWRK-BROADCAST-DA", "D-NWRK-BROADCAST REMOVE"});
+        for (auto i = 2; i < kMleExtensionPduCount; i++) {
+            names.emplace_back("D-Reserved" + std::to_string(i));
+        }
+        names.insert(names.end(), {"U-PREPARE", "U-PREPARE-DA", "U-IRREGULAR CHANNEL ADVICE", "U-CHANNEL CLASS ADVICE",
+                                   "U-RESTORE", "Reserved", "U-CHANNEL REQUEST", "Extended PDU"});
+        for (auto i = 0; i < kMleExtensionPduCount; i++) {
+            names.emplace_back("U-Reserved" + std::to_string(i));
+        }
+        return names;
+    };
+
+    [[nodiscard]] auto packet_type(const MobileLinkEntityPacket& packet) const -> std::size_t override {
         if (packet.mle_protocol_ == MobileLinkEntityProtocolDiscriminator::kMleProtocol) {
+            const std::size_t offset = packet.is_downlink() ? kDownlinkMlePduOffset : kUplinkMlePduOffset;
             auto pdu_type = packet.sdu_.look<3>(0);
 
             if (pdu_type == kExtendedPdu) {
                 auto pdu_type = packet.sdu_.look<4>(3);
-                return (packet.is_downlink() ? downlink_mle_pdu_extension_description_
-                                             : uplink_mle_pdu_extension_description_)
-                    .at(pdu_type);
+                return offset + kMlePduCount + pdu_type;
             }
 
-            return (packet.is_downlink() ? downlink_mle_pdu_description_ : uplink_mle_pdu_description_).at(pdu_type);
+            return offset + pdu_type;
         }
 
-        return to_string(packet.mle_protocol_);
+        return static_cast<std::size_t>(packet.mle_protocol_);
     };
 
-    auto forward(const MobileLinkEntityPacket& packet) -> std::unique_ptr<MobileLinkEntityPacket> override {
+    auto forward(MobileLinkEntityPacket&& packet) -> std::unique_ptr<MobileLinkEntityPacket> override {
         // TODO: currently we only handle CMCE and MM
         switch (packet.mle_protocol_) {
         case MobileLinkEntityProtocolDiscriminator::kMmProtocol:
-            return mm_.parse(packet);
+            return mm_.parse(std::move(packet));
         case MobileLinkEntityProtocolDiscriminator::kCmceProtocol:
-            return cmce_.parse(packet);
+            return cmce_.parse(std::move(packet));
 
         // Fall through for all other unimplemented packet types
         case MobileLinkEntityProtocolDiscriminator::kReserved0:
@@ -73,7 +74,7 @@ class MobileLinkEntityParser : public PacketParser<LogicalLinkControlPacket, Mob
         case MobileLinkEntityProtocolDiscriminator::kMleProtocol:
         case MobileLinkEntityProtocolDiscriminator::kTetraManagementEntityProtocol:
         case MobileLinkEntityProtocolDiscriminator::kReservedForTesting:
-            return std::make_unique<MobileLinkEntityPacket>(packet);
+            return std::make_unique<MobileLinkEntityPacket>(std::move(packet));
         }
     };
 
@@ -82,9 +83,14 @@ class MobileLinkEntityParser : public PacketParser<LogicalLinkControlPacket, Mob
 
     static const auto kExtendedPdu = 7;
 
-    std::array<std::string, 8> downlink_mle_pdu_description_;
-    std::array<std::string, 16> downlink_mle_pdu_extension_description_;
-
-    std::array<std::string, 8> uplink_mle_pdu_description_;
-    std::array<std::string, 16> uplink_mle_pdu_extension_description_;
+    /// The number of MLE protocol discriminators
+    static const auto kMleProtocolCount = 8;
+    /// The number of MLE PDUs in one direction
+    static const auto kMlePduCount = 8;
+    /// The number of MLE extension PDUs in one direction
+    static const auto kMleExtensionPduCount = 16;
+    /// The offset of the downlink MLE PDUs in the packet type names
+    static const std::size_t kDownlinkMlePduOffset = kMleProtocolCount;
+    /// The offset of the uplink MLE PDUs in the packet type names
+    static const std::size_t kUplinkMlePduOffset = kDownlinkMlePduOffset + kMlePduCount + kMleExtensionPduCount;
 };
\ No newline at end of file
@@ -311,7 +311,7 @@ struct MobileManagementPacket : public MobileLinkEntityPacket {
 
     MobileManagementPacket() = default;
 
-    explicit MobileManagementPacket(const MobileLinkEntityPacket& packet);
+    explicit MobileManagementPacket(MobileLinkEntityPacket&& packet);
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(MobileManagementPacket, burst_type_, logical_channel_, type_, encrypted_, address_,
                                    fragmentation_, fragmentation_on_stealling_channel_, reservation_requirement_,
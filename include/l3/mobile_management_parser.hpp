@@ -16,14 +16,30 @@ class MobileManagementParser : public PacketParser<MobileLinkEntityPacket, Mobil
   public:
     MobileManagementParser() = delete;
     explicit MobileManagementParser(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
-        : PacketParser(prometheus_exporter, "mobile_management"){};
+        : PacketParser(prometheus_exporter, "mobile_management", packet_type_names()){};
 
   private:
-    [[nodiscard]] auto packet_name(const MobileManagementPacket& packet) const -> std::string override {
-        return to_string(packet.packet_type_);
+    /// The names of the downlink MM PDUs followed by the names of the uplink MM PDUs
+    static auto packet_type_names() -> std::vector<std::string> {
+        std::vector<std::string> names;
+        for (auto i = 0; i < kPduCount; i++) {
+            names.emplace_back(to_string(MobileManagementDownlinkPacketType(i)));
+        }
+        for (auto i = 0; i < kPduCount; i++) {
+            names.emplace_back(to_string(MobileManagementUplinkPacketType(i)));
+        }
+        return names;
     }
 
-    auto forward(const MobileManagementPacket& packet) -> std::unique_ptr<MobileManagementPacket> override {
-        return std::make_unique<MobileManagementPacket>(packet);
+    [[nodiscard]] auto packet_type(const MobileManagementPacket& packet) const -> std::size_t override {
+        const auto pdu_type = std::visit([](auto&& arg) { return static_cast<std::size_t>(arg); }, packet.packet_type_);
+        return packet.packet_type_.index() * kPduCount + pdu_type;
+    }
+
+    auto forward(MobileManagementPacket&& packet) -> std::unique_ptr<MobileManagementPacket> override {
+        return std::make_unique<MobileManagementPacket>(std::move(packet));
     };
+
+    /// The number of MM PDU types in one direction
+    static const auto kPduCount = 16;
 };
\ No newline at end of file
@@ -53,7 +53,7 @@ struct ShortDataServicePacket : public CircuitModeControlEntityPacket {
 
     ShortDataServicePacket() = default;
 
-    explicit ShortDataServicePacket(const CircuitModeControlEntityPacket& packet);
+    explicit ShortDataServicePacket(CircuitModeControlEntityPacket&& packet);
 
     NLOHMANN_DEFINE_TYPE_INTRUSIVE(ShortDataServicePacket, burst_type_, logical_channel_, type_, encrypted_, address_,
                                    fragmentation_, fragmentation_on_stealling_channel_, reservation_requirement_,
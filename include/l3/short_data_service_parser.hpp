@@ -16,60 +16,66 @@ class ShortDataServiceParser : public PacketParser<CircuitModeControlEntityPacke
   public:
     ShortDataServiceParser() = delete;
     explicit ShortDataServiceParser(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
-        : PacketParser(prometheus_exporter, "short_data_service") {
-        sds_pdu_description_[0] = "Reserved 0";
-        sds_pdu_description_[1] = "OTAK (Over The Air re-Keying for end to end encryption)";
-        sds_pdu_description_[2] = "Simple Text Messaging";
-        sds_pdu_description_[3] = "Simple location system";
-        sds_pdu_description_[4] = "Wireless Datagram Protocol WAP 4";
-        sds_pdu_description_[5] = "Wireless Control Message Protocol WCMP 5";
-        sds_pdu_description_[6] = "M-DMO (Managed DMO) 6";
-        sds_pdu_description_[7] = "PIN authentication";
-        sds_pdu_description_[8] = "End-to-end encrypted message 8";
-        sds_pdu_description_[9] = "Simple immediate text messaging";
-        sds_pdu_description_[10] = "Location information protocol";
-        sds_pdu_description_[11] = "Net Assist Protocol 2 (NAP2)";
-        sds_pdu_description_[12] = "Concatenated SDS message 12";
-        sds_pdu_description_[13] = "DOTAM";
-        sds_pdu_description_[14] = "Simple AGNSS service";
+        : PacketParser(prometheus_exporter, "short_data_service", packet_type_names()){};
+
+  private:
+    /// The names of the SDS protocol identifiers
+    static auto packet_type_names() -> std::vector<std::string> {
+        std::vector<std::string> names(kProtocolIdentifierCount);
+        names[0] = "Reserved 0";
+        names[1] = "OTAK (Over The Air re-Keying for end to end encryption)";
+        names[2] = "Simple Text Messaging";
+        names[3] = "Simple location system";
+        names[4] = "Wireless Datagram Protocol WAP 4";
+        names[5] = "Wireless Control Message Protocol WCMP 5";
+        names[6] = "M-DMO (Managed DMO) 6";
+        names[7] = "PIN authentication";
+        names[8] = "End-to-end encrypted message 8";
+        names[9] = "Simple immediate text messaging";
+        names[10] = "Location information protocol";
+        names[11] = "Net Assist Protocol 2 (NAP2)";
+        names[12] = "Concatenated SDS message 12";
+        names[13] = "DOTAM";
+        names[14] = "Simple AGNSS service";
         for (auto i = 0b00001111; i <= 0b00111111; i++) {
-            sds_pdu_description_[i] = "Reserved for future standard definition " + std::to_string(i);
+            names[i] = "Reserved for future standard definition " + std::to_string(i);
         }
         for (auto i = 0b01000000; i <= 0b01111110; i++) {
-            sds_pdu_description_[i] = "Available for user application definition " + std::to_string(i);
+            names[i] = "Available for user application definition " + std::to_string(i);
         }
-        sds_pdu_description_[127] = "Reserved for extension 127";
-        sds_pdu_description_[128] = "Reserved 128";
-        sds_pdu_description_[129] = "Reserved 129";
-        sds_pdu_description_[130] = "Text Messaging";
-        sds_pdu_description_[131] = "Location system";
-        sds_pdu_description_[132] = "Wireless Datagram Protocol WAP 132";
-        sds_pdu_description_[133] = "Wireless Control Message Protocol WCMP 133";
-        sds_pdu_description_[134] = "M-DMO (Managed DMO) 134";
-        sds_pdu_description_[135] = "Reserved for future standard definition 135";
-        sds_pdu_description_[136] = "End-to-end encrypted message 136";
-        sds_pdu_description_[137] = "Immediate text messaging";
-        sds_pdu_description_[138] = "Message with User Data Header";
-        sds_pdu_description_[139] = "Reserved for future standard definition 139";
-        sds_pdu_description_[140] = "Concatenated SDS message 140";
-        sds_pdu_description_[141] = "AGNSS service";
+        names[127] = "Reserved for extension 127";
+        names[128] = "Reserved 128";
+        names[129] = "Reserved 129";
+        names[130] = "Text Messaging";
+        names[131] = "Location system";
+        names[132] = "Wireless Datagram Protocol WAP 132";
+        names[133] = "Wireless Control Message Protocol WCMP 133";
+        names[134] = "M-DMO (Managed DMO) 134";
+        names[135] = "Reserved for future standard definition 135";
+        names[136] = "End-to-end encrypted message 136";
+        names[137] = "Immediate text messaging";
+        names[138] = "Message with User Data Header";
+        names[139] = "Reserved for future standard definition 139";
+        names[140] = "Concatenated SDS message 140";
+        names[141] = "AGNSS service";
         for (auto i = 0b10001110; i <= 0b10111111; i++) {
-            sds_pdu_description_[i] = "Reserved for future standard definition " + std::to_string(i);
+            names[i] = "Reserved for future standard definition " + std::to_string(i);
         }
         for (auto i = 0b11000000; i <= 0b11111110; i++) {
-            sds_pdu_description_[i] = "Available for user application definition " + std::to_string(i);
+            names[i] = "Available for user application definition " + std::to_string(i);
         }
-        sds_pdu_description_[255] = "Reserved for extension";
+        names[255] = "Reserved for extension";
+        return names;
     };
 
-  private:
-    [[nodiscard]] auto packet_name(const ShortDataServicePacket& packet) const -> std::string override {
-        return sds_pdu_description_.at(packet.protocol_identifier_);
+    [[nodiscard]] auto packet_type(const ShortDataServicePacket& packet) const -> std::size_t override {
+        return packet.protocol_identifier_;
     }
 
-    auto forward(const ShortDataServicePacket& packet) -> std::unique_ptr<ShortDataServicePacket> override {
-        return std::make_unique<ShortDataServicePacket>(packet);
+    auto forward(ShortDataServicePacket&& packet) -> std::unique_ptr<ShortDataServicePacket> override {
+        return std::make_unique<ShortDataServicePacket>(std::move(packet));
     };
 
-    std::array<std::string, 256> sds_pdu_description_;
+    /// The number of SDS protocol identifiers
+    static const auto kProtocolIdentifierCount = 256;
 };
\ No newline at end of file
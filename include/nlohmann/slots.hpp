@@ -10,6 +10,7 @@
 
 #include "l2/slot.hpp"
 #include <nlohmann/json.hpp>
+#include <sstream>
 
 static auto stob(const std::string& str) -> bool {
     bool retval = false;
@@ -66,6 +67,7 @@ template <> struct adl_serializer<Slots> {
             .crc_ok = first_slot_crc_ok,
         });
 
+        // the network time is not part of the serialized slots
         if (second_slot_present) {
             auto second_slot_logical_channel =
                 LogicalChannel(std::stoi(j["second_slot_logical_channel"].template get<std::string>()));
@@ -78,9 +80,9 @@ template <> struct adl_serializer<Slots> {
                 .crc_ok = second_slot_crc_ok,
             });
 
-            slots = Slots(burst_type, slot_type, std::move(first_slot), std::move(second_slot));
+            slots = Slots(burst_type, TimebaseCounter{}, slot_type, std::move(first_slot), std::move(second_slot));
         } else {
-            slots = Slots(burst_type, slot_type, std::move(first_slot));
+            slots = Slots(burst_type, TimebaseCounter{}, slot_type, std::move(first_slot));
         }
     }
 };
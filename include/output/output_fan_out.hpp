@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "l2/logical_link_control_packet.hpp"
+#include "l2/slot.hpp"
+#include "output/output_sink_queue.hpp"
+#include "thread_safe_fifo.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+/// The stage between the upper MAC and the output sinks. Every parsed packet or failed slots is converted to json once
+/// and the shared result is added to the bounded queue of every sink. Each sink runs on its own thread, therefore a
+/// slow sink does not block the others.
+class OutputFanOut {
+  public:
+    OutputFanOut() = delete;
+
+    /// \param queue the queue holds either the parsed packets (std::unique_ptr<LogicalLinkControlPacket>) or Slots that
+    /// failed to decode
+    /// \param termination_flag this flag is set when the fan-out should terminate after finishing all work
+    /// \param output_termination_flag this flag is set when all packets are added to the queues of the sinks
+    /// \param station_uuid the station UUID of this instance of tetra-decoder that is included in every packet
+    /// \param sinks the queues of the sinks
+    /// \param serialize_json_text if the json text of every packet is created for the sinks
+    OutputFanOut(ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue,
+                 std::atomic_bool& termination_flag, std::atomic_bool& output_termination_flag,
+                 std::string station_uuid, std::vector<std::shared_ptr<OutputSinkQueue>> sinks,
+                 bool serialize_json_text);
+
+    ~OutputFanOut();
+
+  private:
+    /// The thread function for continously converting the incomming packets and passing them to the sinks
+    auto worker() -> void;
+
+    /// The input queue
+    ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue_;
+
+    /// The flag that is set when terminating the program
+    std::atomic_bool& termination_flag_;
+
+    /// The flag that is set when all work is passed to the sinks
+    std::atomic_bool& output_termination_flag_;
+
+    /// The station UUID of this instance of tetra-decoder
+    std::string station_uuid_;
+
+    /// The queues of the sinks
+    std::vector<std::shared_ptr<OutputSinkQueue>> sinks_;
+
+    /// If the json text of every packet is created
+    bool serialize_json_text_;
+
+    /// The worker thread
+    std::thread worker_thread_;
+};
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "borzoi/borzoi_endpoint.hpp"
+#include <chrono>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+
+/// A parsed packet or failed slots prepared for the output sinks. It is created once by the fan-out stage and shared
+/// read-only between all sinks.
+struct OutputPacket {
+    /// the kind of the packet, which is also the borzoi endpoint to which it is sent
+    BorzoiEndpoint endpoint;
+    /// the value that keeps related packets in order, e.g. the hash of the address of a mobile station
+    uint64_t route;
+    /// the packet including the time and the station
+    nlohmann::json json;
+    /// the packet serialized as json text. Empty if no sink requires it.
+    std::string json_text;
+    /// the time at which the packet entered the fan-out stage
+    std::chrono::steady_clock::time_point created;
+};
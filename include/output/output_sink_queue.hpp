@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "output/output_packet.hpp"
+#include "prometheus.h"
+#include "thread_safe_fifo.hpp"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+/// The class to provide prometheus metrics to the queue of an output sink
+class OutputSinkMetrics {
+  private:
+    /// The bucket boundaries of the time in seconds a packet waits in the queue of a sink
+    inline static const prometheus::Histogram::BucketBoundaries kLagBuckets{
+        0.0001, 0.001, 0.01, 0.1, 1, 10, 60, 600};
+
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of gauges for the packets in the queue of a sink
+    prometheus::Family<prometheus::Gauge>& queue_family_;
+    /// The gauge for the packets in the queue of this sink
+    prometheus::Gauge& queue_;
+    /// The family of counters for the packets that were dropped by a sink
+    prometheus::Family<prometheus::Counter>& drop_family_;
+    /// The counter for the packets that were dropped because the queue of this sink was full
+    prometheus::Counter& drop_queue_full_;
+    /// The counter for the packets that this sink failed to deliver
+    prometheus::Counter& drop_delivery_failed_;
+    /// The family of histograms for the time a packet waits in the queue of a sink
+    prometheus::Family<prometheus::Histogram>& lag_family_;
+    /// The histogram for the time a packet waits in the queue of this sink
+    prometheus::Histogram& lag_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    OutputSinkMetrics() = delete;
+    explicit OutputSinkMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter, const std::string& sink)
+        : prometheus_exporter_(prometheus_exporter)
+        , queue_family_(prometheus_exporter_->output_sink_queue_gauge())
+        , queue_(queue_family_.Add({{"sink", sink}}))
+        , drop_family_(prometheus_exporter_->output_sink_drop_count())
+        , drop_queue_full_(drop_family_.Add({{"sink", sink}, {"reason", "QueueFull"}}))
+        , drop_delivery_failed_(drop_family_.Add({{"sink", sink}, {"reason", "DeliveryFailed"}}))
+        , lag_family_(prometheus_exporter_->output_sink_lag())
+        , lag_(lag_family_.Add({{"sink", sink}}, kLagBuckets)){};
+
+    /// This function is called every time a packet is added to or taken from the queue.
+    auto set_queued(std::size_t queued) -> void { queue_.Set(static_cast<double>(queued)); }
+
+    /// This function is called for every packet that does not fit into the queue.
+    auto increment_dropped_queue_full() -> void { drop_queue_full_.Increment(); }
+
+    /// This function is called for every packet the sink failed to deliver.
+    auto increment_dropped_delivery_failed() -> void { drop_delivery_failed_.Increment(); }
+
+    /// This function is called for every packet that the sink takes from the queue.
+    /// \param lag the time the packet waited since it entered the fan-out stage
+    auto observe_lag(std::chrono::steady_clock::duration lag) -> void {
+        lag_.Observe(std::chrono::duration<double>(lag).count());
+    }
+};
+
+/// The bounded queue of one output sink. The fan-out stage is the only producer, the thread of the sink is the only
+/// consumer. A slow sink only fills its own queue, packets that do not fit are dropped.
+class OutputSinkQueue {
+  public:
+    OutputSinkQueue() = delete;
+
+    /// \param name the name of the sink that is used in the metrics
+    /// \param capacity the maximum number of packets in the queue
+    /// \param prometheus_exporter the reference to the prometheus exporter that is used for the metrics of the queue
+    OutputSinkQueue(std::string name, std::size_t capacity,
+                    const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+        : name_(std::move(name))
+        , capacity_(capacity) {
+        if (prometheus_exporter) {
+            metrics_ = std::make_unique<OutputSinkMetrics>(prometheus_exporter, name_);
+        }
+    };
+
+    /// Add a packet to the queue if there is space left
+    /// \param packet the shared packet
+    /// \return true if the packet was added, false if it was dropped
+    auto push(std::shared_ptr<const OutputPacket> packet) -> bool {
+        // the size can only decrease between the check and the push, the fan-out stage is the only producer
+        const auto queued = queue_.size();
+        if (queued >= capacity_) {
+            if (metrics_) {
+                metrics_->increment_dropped_queue_full();
+            }
+            return false;
+        }
+
+        queue_.push_back(std::move(packet));
+        if (metrics_) {
+            metrics_->set_queued(queued + 1);
+        }
+        return true;
+    };
+
+    /// Take the oldest packet from the queue
+    /// \return the packet or nullptr if the queue stayed empty for a short time
+    [[nodiscard]] auto get_or_null() -> std::shared_ptr<const OutputPacket> {
+        auto packet = queue_.get_or_null();
+        if (!packet) {
+            return nullptr;
+        }
+
+        if (metrics_) {
+            metrics_->set_queued(queue_.size());
+            metrics_->observe_lag(std::chrono::steady_clock::now() - (*packet)->created);
+        }
+        return std::move(*packet);
+    };
+
+    /// The sink reports that it failed to deliver a packet
+    auto report_delivery_failed() -> void {
+        if (metrics_) {
+            metrics_->increment_dropped_delivery_failed();
+        }
+    };
+
+    [[nodiscard]] auto empty() -> bool { return queue_.empty(); };
+
+    [[nodiscard]] auto size() -> std::size_t { return queue_.size(); };
+
+    [[nodiscard]] auto name() const noexcept -> const std::string& { return name_; };
+
+  private:
+    /// The name of the sink
+    std::string name_;
+    /// The maximum number of packets in the queue
+    std::size_t capacity_;
+    /// The wrapped queue
+    ThreadSafeFifo<std::shared_ptr<const OutputPacket>> queue_;
+    /// The prometheus metrics
+    std::unique_ptr<OutputSinkMetrics> metrics_;
+};
@@ -4,6 +4,8 @@
 #include <memory>
 #include <prometheus/counter.h>
 #include <prometheus/exposer.h>
+#include <prometheus/gauge.h>
+#include <prometheus/histogram.h>
 #include <prometheus/registry.h>
 #include <string>
 
@@ -23,19 +25,52 @@ class PrometheusExporter {
     auto burst_lower_mac_decode_error_count() noexcept -> prometheus::Family<prometheus::Counter>&;
     /// The family of counters for mismatched number of bursts in the downlink lower MAC
     auto burst_lower_mac_mismatch_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+    /// The family of counters for suppressed duplicate detections of uplink bursts
+    auto burst_duplicate_suppressed_count() noexcept -> prometheus::Family<prometheus::Counter>&;
     /// The family of gauges for the network time
     auto lower_mac_time_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
 
+    /// The family of gauges for the carrier frequency offset of the IQ stream
+    auto iq_frequency_offset_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
+
     /// The family of counters for all received slots
     auto upper_mac_total_slot_count() noexcept -> prometheus::Family<prometheus::Counter>&;
     /// The family of counters for all received slots with errors
     auto upper_mac_slot_error_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+    /// The family of counters for the categories of parse errors in the upper MAC
+    auto upper_mac_parse_error_count() noexcept -> prometheus::Family<prometheus::Counter>&;
 
     /// The family of counters for all received c-plane fragments
     auto upper_mac_fragment_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+    /// The family of gauges for the c-plane packets that are currently being reassembled
+    auto upper_mac_fragment_reassembly_live() noexcept -> prometheus::Family<prometheus::Gauge>&;
+    /// The family of counters for the c-plane packets whose reassembly was abandoned
+    auto upper_mac_fragment_reassembly_evicted_count() noexcept -> prometheus::Family<prometheus::Counter>&;
 
     /// The family of counters for all received packets in a protocol layer.
     auto packet_count(const std::string& protocol) noexcept -> prometheus::Family<prometheus::Counter>&;
+
+    /// The family of histograms for the number of packets in a request to borzoi
+    auto borzoi_batch_size() noexcept -> prometheus::Family<prometheus::Histogram>&;
+    /// The family of histograms for the time it takes to send a request to borzoi
+    auto borzoi_request_latency() noexcept -> prometheus::Family<prometheus::Histogram>&;
+    /// The family of counters for the bytes of the request bodies sent to borzoi
+    auto borzoi_request_body_bytes_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+    /// The family of gauges for the packets that wait to be sent to borzoi
+    auto borzoi_backlog_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
+    /// The family of gauges for the requests that are queued or sent on the connections to borzoi
+    auto borzoi_in_flight_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
+    /// The family of gauges for the size of the spool of undelivered borzoi packets
+    auto borzoi_spool_size_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
+    /// The family of counters for the packets that pass through the spool of undelivered borzoi packets
+    auto borzoi_spool_record_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+
+    /// The family of gauges for the packets in the queues of the output sinks
+    auto output_sink_queue_gauge() noexcept -> prometheus::Family<prometheus::Gauge>&;
+    /// The family of counters for the packets dropped by the output sinks
+    auto output_sink_drop_count() noexcept -> prometheus::Family<prometheus::Counter>&;
+    /// The family of histograms for the time packets wait in the queues of the output sinks
+    auto output_sink_lag() noexcept -> prometheus::Family<prometheus::Histogram>&;
 };
 
 #endif // PROMETHEUS_H
@@ -17,6 +17,7 @@
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <utility>
 #include <vector>
 #if defined(__linux__)
 #include <pthread.h>
@@ -24,7 +25,8 @@
 
 struct TerminationToken {};
 
-// thread pool executing work but outputting it the order of the input
+// thread pool executing work but outputting it the order of the input. The results are moved to the output, so they may
+// be move-only types.
 template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
 
   public:
@@ -59,7 +61,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
     void queue_work(std::function<ReturnType()> work) {
         {
             std::lock_guard<std::mutex> lock(cv_input_item_mutex_);
-            input_queue_.emplace_back(std::make_pair(input_counter_++, work));
+            input_queue_.emplace_back(input_counter_++, std::move(work));
         }
         cv_input_item_.notify_one();
     };
@@ -74,7 +76,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
             std::lock_guard<std::mutex> lk(cv_output_item_mutex_);
 
             if (auto search = output_map_.find(output_counter_); search != output_map_.end()) {
-                result = search->second;
+                result = std::move(search->second);
                 output_map_.erase(search);
                 output_counter_++;
             }
@@ -86,7 +88,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
             auto res = cv_output_item_.wait_for(lk, 10ms, [&] {
                 // find the output item and if found set outputCounter_ to the next item
                 if (auto search = output_map_.find(output_counter_); search != output_map_.end()) {
-                    result = search->second;
+                    result = std::move(search->second);
                     output_map_.erase(search);
                     output_counter_++;
                     return true;
@@ -121,7 +123,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
             {
                 std::lock_guard lk(cv_input_item_mutex_);
                 if (!input_queue_.empty()) {
-                    work = input_queue_.front();
+                    work = std::move(input_queue_.front());
                     input_queue_.pop_front();
                 } else if (input_termination_flag_.load()) {
                     break;
@@ -132,7 +134,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
                 std::unique_lock<std::mutex> lk(cv_input_item_mutex_);
                 cv_input_item_.wait_for(lk, 10ms, [&] {
                     if (!input_queue_.empty()) {
-                        work = input_queue_.front();
+                        work = std::move(input_queue_.front());
                         input_queue_.pop_front();
                         return true;
                     }
@@ -149,7 +151,7 @@ template <typename ReturnType> class StreamingOrderedOutputThreadPoolExecutor {
 
                 {
                     std::lock_guard<std::mutex> lock(cv_output_item_mutex_);
-                    output_map_[index] = result;
+                    output_map_[index] = std::move(result);
                 }
                 cv_output_item_.notify_all();
             }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <condition_variable>
+#include <cstddef>
 #include <deque>
 #include <mutex>
 #include <optional>
@@ -63,6 +64,11 @@ template <typename T> class ThreadSafeFifo {
         return queue_.empty();
     };
 
+    auto size() -> std::size_t {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return queue_.size();
+    };
+
     auto push_back(T&& element) -> void {
         {
             std::lock_guard<std::mutex> lk(mutex_);
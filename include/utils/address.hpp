@@ -11,10 +11,54 @@
 #include "nlohmann/std_optional.hpp"    // IWYU pragma: keep
 #include "nlohmann/unsigned_bitint.hpp" // IWYU pragma: keep
 #include "utils/bit_vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <nlohmann/json.hpp>
 #include <optional>
-#include <sstream>
+
+/// The canonical packed representation of an Address. All fields and their presence are packed into 128 bits, which
+/// allows comparing and hashing an Address with a few integer operations. Use it as the key wherever addresses index
+/// state.
+class AddressKey {
+  private:
+    /// presence bits (8), country code (10), network code (14), sna (8) and ssi (24)
+    uint64_t high_ = 0;
+    /// event label (10), ussi (24), smi (24) and usage marker (6)
+    uint64_t low_ = 0;
+
+    /// Finalizer of splitmix64 to spread the bits of the fields over the whole hash
+    static constexpr auto mix(uint64_t value) noexcept -> uint64_t {
+        value ^= value >> 30;
+        value *= 0xbf58476d1ce4e5b9ULL;
+        value ^= value >> 27;
+        value *= 0x94d049bb133111ebULL;
+        value ^= value >> 31;
+        return value;
+    }
+
+  public:
+    constexpr AddressKey() = default;
+    constexpr AddressKey(uint64_t high, uint64_t low) noexcept
+        : high_(high)
+        , low_(low){};
+
+    [[nodiscard]] constexpr auto high() const noexcept -> uint64_t { return high_; };
+    [[nodiscard]] constexpr auto low() const noexcept -> uint64_t { return low_; };
+
+    [[nodiscard]] constexpr auto hash() const noexcept -> std::size_t {
+        return static_cast<std::size_t>(mix(high_ ^ mix(low_)));
+    };
+
+    constexpr auto operator==(const AddressKey& other) const noexcept -> bool {
+        return high_ == other.high_ && low_ == other.low_;
+    };
+    constexpr auto operator!=(const AddressKey& other) const noexcept -> bool { return !(*this == other); };
+    constexpr auto operator<(const AddressKey& other) const noexcept -> bool {
+        return high_ < other.high_ || (high_ == other.high_ && low_ < other.low_);
+    };
+};
 
 class Address {
   public:
@@ -27,13 +71,35 @@ class Address {
     /// extract the address from the address type and addres fields in MAC-RESOURCE
     static auto from_mac_resource(BitVector& data) -> Address;
 
-    // explicit operator bool() const = delete;
-    constexpr auto operator==(Address address_type) const -> bool {
-        return country_code_ == address_type.country_code_ && network_code_ == address_type.network_code_ &&
-               sna_ == address_type.sna_ && ssi_ == address_type.ssi_ && event_label_ == address_type.event_label_ &&
-               ussi_ == address_type.ussi_ && smi_ == address_type.smi_ && usage_marker_ == address_type.usage_marker_;
+    /// Pack all fields into the canonical key of this address
+    [[nodiscard]] constexpr auto key() const noexcept -> AddressKey {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        auto pack = [](uint64_t& word, uint64_t& presence, const auto& field, unsigned bits) {
+            word <<= bits;
+            presence <<= 1;
+            if (field) {
+                word |= static_cast<uint64_t>(*field);
+                presence |= 1;
+            }
+        };
+
+        uint64_t presence = 0;
+        pack(high, presence, country_code_, 10);
+        pack(high, presence, network_code_, 14);
+        pack(high, presence, sna_, 8);
+        pack(high, presence, ssi_, 24);
+        pack(low, presence, event_label_, 10);
+        pack(low, presence, ussi_, 24);
+        pack(low, presence, smi_, 24);
+        pack(low, presence, usage_marker_, 6);
+
+        return {high | (presence << 56), low};
     }
 
+    // explicit operator bool() const = delete;
+    constexpr auto operator==(const Address& address_type) const -> bool { return key() == address_type.key(); }
+
     void set_country_code(unsigned _BitInt(10) country_code) { country_code_ = country_code; }
     void set_network_code(unsigned _BitInt(14) network_code) { network_code_ = network_code; }
     void set_sna(unsigned _BitInt(8) sna) { sna_ = sna; }
@@ -86,11 +152,7 @@ class Address {
     }
 
     // Overload this operator for usage of the Address as a map key
-    auto operator<(const Address& other) const -> bool {
-        return std::tie(country_code_, network_code_, sna_, ssi_, event_label_, ussi_, smi_, usage_marker_) <
-               std::tie(other.country_code_, other.network_code_, other.sna_, other.ssi_, other.event_label_,
-                        other.ussi_, other.smi_, other.usage_marker_);
-    }
+    auto operator<(const Address& other) const -> bool { return key() < other.key(); }
 
     friend auto operator<<(std::ostream& stream, const Address& address_type) -> std::ostream&;
 
@@ -109,12 +171,12 @@ class Address {
 };
 
 namespace std {
+template <> struct hash<AddressKey> {
+    auto operator()(const AddressKey& k) const noexcept -> std::size_t { return k.hash(); }
+};
+
 template <> struct hash<Address> {
-    auto operator()(const Address& k) const -> std::size_t {
-        auto stream = std::stringstream();
-        stream << k;
-        return std::hash<std::string>()(stream.str());
-    }
+    auto operator()(const Address& k) const noexcept -> std::size_t { return k.key().hash(); }
 };
 } // namespace std
 
@@ -9,19 +9,40 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <ostream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 /// Construct a vector of bits that allows taking ranges of bits from the internal representation. The internal
 /// representation is not copied if bits are taken.
+/// The bits are packed into 64-bit words in big-endian bit order, i.e. the first bit is the most significant bit of the
+/// first word. Taking a field of up to 64 bits therefore only needs to access at most two words.
+/// Up to 512 bits are stored inline, which covers the AACH, BSCH, SCH/HD and SCH/F blocks and most fields of the upper
+/// layers without touching the allocator. Longer bitvectors hold their words in an immutable buffer that is shared
+/// between all BitVectors that were sliced from it with take_vector or copied. Only the construction from bits,
+/// append and concatenate create a new buffer.
 class BitVector {
   private:
-    /// The bits we hold
-    std::vector<bool> data_;
+    /// The number of bits in one word of the storage
+    static constexpr std::size_t kWordBits = 64;
+
+    /// The number of words that can be stored without a heap allocation
+    static constexpr std::size_t kInlineWords = 8;
+
+    /// The bits we hold packed into words if they fit into the inline storage
+    std::array<uint64_t, kInlineWords> inline_data_{};
+    /// The bits we hold packed into words if they do not fit into the inline storage. This buffer is never modified
+    /// after creation.
+    std::shared_ptr<const std::vector<uint64_t>> data_;
     /// The length of the currently viewed data to support taking bits from the back.
     std::size_t len_ = 0;
     /// The current read offset to support taking bits from the front.
@@ -30,11 +51,19 @@ class BitVector {
   public:
     BitVector() = default;
     explicit BitVector(const std::vector<bool>& vec)
-        : data_(vec)
-        , len_(data_.size()){};
-    explicit BitVector(std::vector<bool>&& vec)
-        : data_(std::move(vec))
-        , len_(data_.size()){};
+        : BitVector(vec.cbegin(), vec.cend()){};
+
+    /// Construct a bitvector from a range of bools
+    template <typename Iterator>
+    BitVector(Iterator begin, Iterator end)
+        : len_(std::distance(begin, end)) {
+        auto* words = allocate(len_);
+        for (std::size_t i = 0; begin != end; ++begin, ++i) {
+            if (*begin) {
+                words[i / kWordBits] |= uint64_t{1} << (kWordBits - 1 - i % kWordBits);
+            }
+        }
+    };
 
     BitVector(const BitVector&) = default;
     auto operator=(const BitVector&) -> BitVector& = default;
@@ -45,40 +74,54 @@ class BitVector {
 
     [[nodiscard]] inline auto bits_left() const noexcept -> auto{ return len_; };
 
-    /// Append another bitvector to the current one. This will cause data to be copied.
+    /// Append another bitvector to the current one. This will cause data to be copied into a new buffer.
     auto append(const BitVector& other) -> void;
 
+    /// Concatenate the views of multiple bitvectors into a new one. Only a single buffer is created for the result,
+    /// which makes this preferable over repeated calls to append.
+    /// \param segments the bitvectors that should be concatenated in order
+    /// \return the bitvector holding the bits of all segments
+    [[nodiscard]] static auto concatenate(const std::vector<BitVector>& segments) -> BitVector;
+
     /// Take N unsigned bits from the start of the bitvector view. N is known at compile time.
     // TODO: assert N != 0
     template <std::size_t N> [[nodiscard]] auto take() -> unsigned _BitInt(N) {
         if (N > bits_left()) {
+            if (non_throwing_) {
+                mark_truncated();
+                return 0;
+            }
             throw std::runtime_error(std::to_string(N) + " bits not left in BitVec (" + std::to_string(bits_left()) +
                                      ")");
         }
 
-        const auto bits = data_.begin() + read_offset_;
+        const auto position = read_offset_;
 
         // delete first n entries
         read_offset_ += N;
         len_ -= N;
 
-        return to_bit_int<N>(bits);
+        return to_bit_int<N>(position);
     };
 
     /// Take N unsigned bits from the end of the bitvector view. N is known at compile time.
     // TODO: assert N != 0
     template <std::size_t N> [[nodiscard]] auto take_last() -> unsigned _BitInt(N) {
         if (N > bits_left()) {
+            if (non_throwing_) {
+                mark_truncated();
+                return 0;
+            }
             throw std::runtime_error(std::to_string(N) + " bits not left in BitVec (" + std::to_string(bits_left()) +
                                      ")");
         }
 
-        const auto bits = data_.begin() + read_offset_ + bits_left() - N;
+        const auto position = read_offset_ + bits_left() - N;
 
         // delete last n entries
         len_ -= N;
 
-        return to_bit_int<N>(bits);
+        return to_bit_int<N>(position);
     }
 
     /// look at N bits with an offset to the bitvector
@@ -88,14 +131,12 @@ class BitVector {
                                      std::to_string(bits_left()) + ")");
         }
 
-        const auto bits = data_.begin() + read_offset_ + offset;
-
-        return to_bit_int<N>(bits);
+        return to_bit_int<N>(read_offset_ + offset);
     }
 
     [[nodiscard]] auto compute_fcs() -> uint32_t;
 
-    /// bite of a bitvector from the current bitvector
+    /// bite of a bitvector from the current bitvector. The returned bitvector shares the buffer with this one.
     [[nodiscard]] auto take_vector(std::size_t number_bits) -> BitVector;
 
     /// take all the remaining bits
@@ -103,10 +144,23 @@ class BitVector {
 
     [[nodiscard]] auto is_mac_padding() const noexcept -> bool;
 
+    /// Do not throw if more bits are taken than are left. Instead zero is returned, the view is emptied and the
+    /// bitvector is marked as truncated. This allows parsers to check for truncation once after parsing a PDU instead
+    /// of unwinding an exception for every malformed PDU. BitVectors taken with take_vector throw again, as they are
+    /// passed to the upper layers.
+    auto set_non_throwing() noexcept -> void { non_throwing_ = true; };
+
+    /// check if more bits were taken than were left in non throwing mode
+    [[nodiscard]] auto truncated() const noexcept -> bool { return truncated_; };
+
     /// function to remove fill bits of a bitvector once and only once
     auto remove_fill_bits() -> void {
         if (!fill_bits_removed_) {
             while (take_last<1>() == 0b0) {
+                // there is no set bit that terminates the fill bits
+                if (truncated_) {
+                    break;
+                }
             }
 
             fill_bits_removed_ = true;
@@ -115,26 +169,82 @@ class BitVector {
 
     friend auto operator<<(std::ostream& stream, const BitVector& vec) -> std::ostream&;
 
-    NLOHMANN_DEFINE_TYPE_INTRUSIVE(BitVector, data_, len_, read_offset_)
+    friend auto to_json(nlohmann::json& json, const BitVector& vec) -> void;
+    friend auto from_json(const nlohmann::json& json, BitVector& vec) -> void;
 
   private:
-    template <std::size_t N>
-    [[nodiscard]] auto to_bit_int(const std::vector<bool>::const_iterator iterator) const -> unsigned _BitInt(N) {
-        unsigned _BitInt(N) ret = iterator[0];
-
-        // This condition is implicitly there on the first iteation of the loop, but not detected by some compilers
-        // leading to a false warning: shift count >= width of type [-Wshift-count-overflow] with N == 1
-        if (N > 1) {
-            for (auto i = 1; i < N; i++) {
-                ret <<= 1;
-                ret |= iterator[i];
-            }
+    /// Empty the view and remember that more bits were taken than were left
+    auto mark_truncated() noexcept -> void {
+        read_offset_ += len_;
+        len_ = 0;
+        truncated_ = true;
+    };
+
+    /// Select the inline storage or create a new buffer that can hold the given number of bits
+    /// \param number_bits the number of bits that need to be stored
+    /// \return the zeroed words which may be written until the bitvector is shared
+    [[nodiscard]] auto allocate(std::size_t number_bits) -> uint64_t*;
+
+    /// Get the words of the storage that is in use
+    [[nodiscard]] auto words() const noexcept -> const uint64_t* {
+        return data_ ? data_->data() : inline_data_.data();
+    }
+
+    /// Copy the bits of the current view into packed words
+    /// \param data the packed words which receive the bits. The destination bits must be zero.
+    /// \param position the position of the first bit to write
+    auto copy_view_into(uint64_t* data, std::size_t position) const -> void;
+
+    /// Extract up to 64 bits from the storage. The bits may span at most two words.
+    /// \param position the absolute position of the first bit in the storage
+    /// \param number_bits the number of bits to extract, must be between 1 and 64
+    /// \return the bits with the last bit in the least significant bit
+    [[nodiscard]] auto extract(std::size_t position, std::size_t number_bits) const noexcept -> uint64_t {
+        const auto* data = words();
+        const auto word = position / kWordBits;
+        const auto bit = position % kWordBits;
+
+        auto value = data[word] << bit;
+        if (bit + number_bits > kWordBits) {
+            value |= data[word + 1] >> (kWordBits - bit);
         }
 
-        return ret;
+        return value >> (kWordBits - number_bits);
+    }
+
+    /// Get a single bit from the storage
+    /// \param position the absolute position of the bit in the storage
+    [[nodiscard]] auto bit_at(std::size_t position) const noexcept -> bool {
+        return ((words()[position / kWordBits] >> (kWordBits - 1 - position % kWordBits)) & 1U) != 0U;
+    }
+
+    template <std::size_t N> [[nodiscard]] auto to_bit_int(std::size_t position) const noexcept -> unsigned _BitInt(N) {
+        if constexpr (N <= kWordBits) {
+            return static_cast<unsigned _BitInt(N)>(extract(position, N));
+        } else {
+            unsigned _BitInt(N) ret = 0;
+
+            for (std::size_t remaining = N; remaining > 0;) {
+                const auto chunk = std::min(remaining, kWordBits);
+                ret <<= chunk;
+                ret |= extract(position, chunk);
+                position += chunk;
+                remaining -= chunk;
+            }
+
+            return ret;
+        }
     }
 
     bool fill_bits_removed_ = false;
+
+    /// Return zero instead of throwing if too many bits are taken
+    bool non_throwing_ = false;
+    /// Set if more bits were taken than were left in non throwing mode
+    bool truncated_ = false;
 };
 
-auto operator<<(std::ostream& stream, const BitVector& vec) -> std::ostream&;
\ No newline at end of file
+auto operator<<(std::ostream& stream, const BitVector& vec) -> std::ostream&;
+
+auto to_json(nlohmann::json& json, const BitVector& vec) -> void;
+auto from_json(const nlohmann::json& json, BitVector& vec) -> void;
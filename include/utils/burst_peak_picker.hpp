@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "utils/burst_peak_picker_metrics.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+
+/// The correlation of the training sequences crosses the detection threshold at several adjacent offsets around the
+/// true position of a burst. This class collects the detections that lie within a window of each other and only
+/// emits the one with the best quality, so every burst is passed to the lower mac once.
+/// \tparam Burst the detected burst. It needs a member burst_type of type BurstType.
+template <typename Burst> class BurstPeakPicker {
+  public:
+    using EmitFunction = std::function<void(Burst&&)>;
+
+    BurstPeakPicker() = delete;
+    /// \param window the maximum distance of detections in stream positions that belong to the same burst
+    /// \param emit the function that is called with the best detection of each burst
+    /// \param prometheus_exporter the optional prometheus exporter to count suppressed detections
+    BurstPeakPicker(std::size_t window, EmitFunction emit,
+                    const std::shared_ptr<PrometheusExporter>& prometheus_exporter = nullptr)
+        : window_(window)
+        , emit_(std::move(emit)) {
+        if (prometheus_exporter) {
+            metrics_ = std::make_unique<BurstPeakPickerMetrics>(prometheus_exporter);
+        }
+    };
+
+    /// Add a detection of a burst. If it belongs to the burst of the held detection, only the better one is kept.
+    /// \param position the position of the detection in the stream, must not decrease between calls
+    /// \param quality the quality of the detection, higher is better
+    /// \param burst the detected burst
+    auto detect(std::size_t position, float quality, Burst&& burst) -> void {
+        advance(position);
+
+        if (!candidate_) {
+            candidate_ = Candidate{.position = position, .quality = quality, .burst = std::move(burst)};
+            return;
+        }
+
+        if (quality > candidate_->quality) {
+            increment_suppressed(candidate_->burst.burst_type);
+            candidate_ = Candidate{.position = position, .quality = quality, .burst = std::move(burst)};
+        } else {
+            increment_suppressed(burst.burst_type);
+        }
+    };
+
+    /// Advance the stream position. The held detection is emitted once no better detection can follow.
+    /// \param position the current position in the stream
+    auto advance(std::size_t position) -> void {
+        if (candidate_ && position - candidate_->position > window_) {
+            emit_(std::move(candidate_->burst));
+            candidate_.reset();
+        }
+    };
+
+    /// Emit the held detection at the end of the stream, where no further detection can follow
+    auto flush() -> void {
+        if (candidate_) {
+            emit_(std::move(candidate_->burst));
+            candidate_.reset();
+        }
+    };
+
+  private:
+    struct Candidate {
+        std::size_t position;
+        float quality;
+        Burst burst;
+    };
+
+    auto increment_suppressed(BurstType burst_type) -> void {
+        if (metrics_) {
+            metrics_->increment(burst_type);
+        }
+    };
+
+    /// the maximum distance of detections that belong to the same burst
+    std::size_t window_;
+    /// the function that is called with the best detection of each burst
+    EmitFunction emit_;
+    /// the best detection of the current burst
+    std::optional<Candidate> candidate_;
+
+    std::unique_ptr<BurstPeakPickerMetrics> metrics_;
+};
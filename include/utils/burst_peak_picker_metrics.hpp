@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include "burst_type.hpp"
+#include "prometheus.h"
+#include <memory>
+
+/// The class to provide prometheus metrics to the burst peak picker
+class BurstPeakPickerMetrics {
+  private:
+    /// The prometheus exporter
+    std::shared_ptr<PrometheusExporter> prometheus_exporter_;
+
+    // NOLINTBEGIN(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+    /// The family of counters for suppressed duplicate burst detections
+    prometheus::Family<prometheus::Counter>& burst_duplicate_suppressed_count_family_;
+    /// The counter for the suppressed duplicate ControlUplinkBurst detections
+    prometheus::Counter& control_uplink_burst_duplicate_suppressed_count_;
+    /// The counter for the suppressed duplicate NormalUplinkBurst detections
+    prometheus::Counter& normal_uplink_burst_duplicate_suppressed_count_;
+    /// The counter for the suppressed duplicate NormalUplinkBurstSplit detections
+    prometheus::Counter& normal_uplink_burst_split_duplicate_suppressed_count_;
+
+    // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+  public:
+    BurstPeakPickerMetrics() = delete;
+    explicit BurstPeakPickerMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+        : prometheus_exporter_(prometheus_exporter)
+        , burst_duplicate_suppressed_count_family_(prometheus_exporter_->burst_duplicate_suppressed_count())
+        , control_uplink_burst_duplicate_suppressed_count_(
+              burst_duplicate_suppressed_count_family_.Add({{"burst_type", "ControlUplinkBurst"}}))
+        , normal_uplink_burst_duplicate_suppressed_count_(
+              burst_duplicate_suppressed_count_family_.Add({{"burst_type", "NormalUplinkBurst"}}))
+        , normal_uplink_burst_split_duplicate_suppressed_count_(
+              burst_duplicate_suppressed_count_family_.Add({{"burst_type", "NormalUplinkBurstSplit"}})){};
+
+    /// This function is called for every suppressed duplicate burst detection.
+    /// \param burst_type the type of the burst that was suppressed
+    auto increment(const BurstType burst_type) -> void {
+        switch (burst_type) {
+        case BurstType::ControlUplinkBurst:
+            control_uplink_burst_duplicate_suppressed_count_.Increment();
+            break;
+        case BurstType::NormalUplinkBurst:
+            normal_uplink_burst_duplicate_suppressed_count_.Increment();
+            break;
+        case BurstType::NormalUplinkBurstSplit:
+            normal_uplink_burst_split_duplicate_suppressed_count_.Increment();
+            break;
+        case BurstType::NormalDownlinkBurst:
+        case BurstType::NormalDownlinkBurstSplit:
+        case BurstType::SynchronizationBurst:
+            // downlink bursts are aligned by the synchronization and are not passed through the peak picker
+            break;
+        }
+    }
+};
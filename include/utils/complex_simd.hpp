@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+
+/// Multiply a vector of complex values by a complex scalar and add the result to an accumulator.
+/// acc[i] += input[i] * factor
+/// \param input the vector of complex values
+/// \param factor the complex scalar
+/// \param acc the accumulator, must hold at least len elements
+/// \param len the number of elements to process
+auto complex_multiply_accumulate(const std::complex<float>* input, std::complex<float> factor,
+                                 std::complex<float>* acc, std::size_t len) noexcept -> void;
+
+/// Multiply a vector of complex values by a complex scalar.
+/// output[i] = input[i] * factor
+/// \param input the vector of complex values
+/// \param factor the complex scalar
+/// \param output the output vector, must hold at least len elements. It may alias input.
+/// \param len the number of elements to process
+auto complex_scale(const std::complex<float>* input, std::complex<float> factor, std::complex<float>* output,
+                   std::size_t len) noexcept -> void;
+
+/// Multiply two vectors of complex values element-wise.
+/// output[i] = lhs[i] * rhs[i]
+/// \param lhs the first vector of complex values
+/// \param rhs the second vector of complex values
+/// \param output the output vector, must hold at least len elements. It may alias lhs or rhs.
+/// \param len the number of elements to process
+auto complex_multiply(const std::complex<float>* lhs, const std::complex<float>* rhs, std::complex<float>* output,
+                      std::size_t len) noexcept -> void;
@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// The sample format of the interleaved IQ stream received from the phy or replayed from a file.
+enum class IQFormat {
+    /// interleaved 32-bit float I and Q (std::complex<float>), 8 bytes per sample
+    kComplexFloat32,
+    /// interleaved signed 16-bit integer I and Q, 4 bytes per sample
+    kComplexInt16,
+    /// interleaved signed 8-bit integer I and Q, 2 bytes per sample
+    kComplexInt8,
+};
+
+constexpr auto to_string(IQFormat format) noexcept -> const char* {
+    switch (format) {
+    case IQFormat::kComplexFloat32:
+        return "cf32";
+    case IQFormat::kComplexInt16:
+        return "cs16";
+    case IQFormat::kComplexInt8:
+        return "cs8";
+    }
+};
+
+/// Get the number of bytes that one complex sample occupies on the wire
+/// \param format the format of the IQ samples
+/// \return the size of one complex sample in bytes
+constexpr auto bytes_per_sample(IQFormat format) noexcept -> std::size_t {
+    switch (format) {
+    case IQFormat::kComplexFloat32:
+        return 2 * sizeof(float);
+    case IQFormat::kComplexInt16:
+        return 2 * sizeof(int16_t);
+    case IQFormat::kComplexInt8:
+        return 2 * sizeof(int8_t);
+    }
+};
+
+/// Parse the IQ format from its command line representation
+/// \param name the name of the format (cf32, cs16 or cs8)
+/// \return the parsed IQ format
+[[nodiscard]] auto iq_format_from_string(const std::string& name) -> IQFormat;
+
+/// Convert interleaved IQ samples in the given format to complex floats. Integer samples are scaled to [-1, 1).
+/// \param format the format of the samples in the input buffer
+/// \param input the buffer holding the interleaved IQ samples
+/// \param sample_count the number of complex samples in the input buffer
+/// \param output the buffer which receives the converted samples, must hold at least sample_count elements
+auto convert_iq_samples(IQFormat format, const uint8_t* input, std::size_t sample_count, std::complex<float>* output)
+    -> void;
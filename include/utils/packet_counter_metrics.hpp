@@ -9,8 +9,13 @@
 #pragma once
 
 #include "prometheus.h"
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <vector>
 
+/// The counters for the received packet types of one protocol. All the counters are registered on construction and
+/// addressed by the index of the packet type, so counting a packet does not require a lookup by name.
 class PacketCounterMetrics {
   private:
     /// The prometheus exporter
@@ -21,36 +26,35 @@ class PacketCounterMetrics {
     /// The family of counters for packet counts
     prometheus::Family<prometheus::Counter>& received_packet_count_;
 
-    /// Map from the name of the received packet to the counter for it.
-    std::map<std::string, prometheus::Counter*> received_packet_counter_map_;
-
     // NOLINTEND(cppcoreguidelines-avoid-const-or-ref-data-members)
 
+    /// The counter for each packet type index
+    std::vector<prometheus::Counter*> received_packet_counters_;
+
   public:
     PacketCounterMetrics() = delete;
+    /// \param prometheus_exporter the prometheus exporter
+    /// \param protocol the name of the protocol whose packets are counted
+    /// \param packet_type_names the name of each packet type. The index into this vector is the packet type index.
+    /// Packet types with the same name share one counter.
     explicit PacketCounterMetrics(const std::shared_ptr<PrometheusExporter>& prometheus_exporter,
-                                  const std::string& protocol)
+                                  const std::string& protocol, const std::vector<std::string>& packet_type_names)
         : prometheus_exporter_(prometheus_exporter)
-        , received_packet_count_(prometheus_exporter_->packet_count(protocol)){};
-
-    /// This function is called for every packet_type
-    /// \param packet_type the type of the packet described as a name
-    auto increment(const std::string& packet_type) -> void {
-        if (!received_packet_counter_map_.count(packet_type)) {
-            received_packet_counter_map_[packet_type] = &received_packet_count_.Add({{"packet_type", packet_type}});
+        , received_packet_count_(prometheus_exporter_->packet_count(protocol)) {
+        received_packet_counters_.reserve(packet_type_names.size());
+        for (const auto& packet_type_name : packet_type_names) {
+            received_packet_counters_.push_back(&received_packet_count_.Add({{"packet_type", packet_type_name}}));
         }
-
-        received_packet_counter_map_[packet_type]->Increment();
     };
 
     /// This function is called for every packet_type
-    /// \param packet_type the type of the packet described as a name
-    /// \param increment how much should the counter be incremented
-    auto increment(const std::string& packet_type, unsigned increment) -> void {
-        if (!received_packet_counter_map_.count(packet_type)) {
-            received_packet_counter_map_[packet_type] = &received_packet_count_.Add({{"packet_type", packet_type}});
-        }
+    /// \param packet_type the index of the packet type
+    auto increment(std::size_t packet_type) -> void { received_packet_counters_.at(packet_type)->Increment(); };
 
-        received_packet_counter_map_[packet_type]->Increment(increment);
+    /// This function is called for every packet_type
+    /// \param packet_type the index of the packet type
+    /// \param increment how much should the counter be incremented
+    auto increment(std::size_t packet_type, unsigned increment) -> void {
+        received_packet_counters_.at(packet_type)->Increment(increment);
     }
-};
\ No newline at end of file
+};
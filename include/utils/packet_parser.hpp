@@ -10,12 +10,17 @@
 
 #include "prometheus.h"
 #include "utils/packet_counter_metrics.hpp"
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 /// This is the template that is used to keep an consistent interface in the protocol parsing.
-/// 1. The input of type Input is passed into the constructor of type Output.
+/// 1. The input of type Input is moved into the constructor of type Output.
 /// 2. The metrics are incremented in the increment_metrics function.
-/// 3. The packet is forwared to the next parsing stage or returned if this is not necessary.
+/// 3. The packet is moved to the next parsing stage or returned if this is not necessary.
+/// The packet is moved from layer to layer, so the data of the lower layers is not copied when a packet is parsed.
 template <typename Input, typename Output> class PacketParser {
   private:
     /// The metrics for this parser
@@ -25,31 +30,39 @@ template <typename Input, typename Output> class PacketParser {
     PacketParser() = delete;
     virtual ~PacketParser() = default;
 
+    /// \param prometheus_exporter the prometheus exporter
+    /// \param packet_parser_name the name of the protocol that is parsed
+    /// \param packet_type_names the names of the packet types indexed by the value returned from packet_type
     explicit PacketParser(const std::shared_ptr<PrometheusExporter>& prometheus_exporter,
-                          const std::string& packet_parser_name) {
+                          const std::string& packet_parser_name, const std::vector<std::string>& packet_type_names) {
         if (prometheus_exporter) {
-            metrics_ = std::make_unique<PacketCounterMetrics>(prometheus_exporter, packet_parser_name);
+            metrics_ =
+                std::make_unique<PacketCounterMetrics>(prometheus_exporter, packet_parser_name, packet_type_names);
         }
     };
 
     /// Parse the input packet, increment the metrics and return the parsed packet passed through all the layers defined
     /// in the forward function.
-    virtual auto parse(const Input& input) -> std::unique_ptr<Output> {
+    virtual auto parse(Input&& input) -> std::unique_ptr<Output> {
         /// Parse this layer
-        auto packet = Output(input);
+        auto packet = Output(std::move(input));
         /// Increment the metrics
         if (metrics_) {
-            metrics_->increment(packet_name(packet));
+            metrics_->increment(packet_type(packet));
         }
         /// Forward it to further parsing steps
-        return forward(packet);
+        return forward(std::move(packet));
     };
 
+    /// Parse a copy of the input packet.
+    auto parse(const Input& input) -> std::unique_ptr<Output> { return parse(Input(input)); };
+
   protected:
-    /// This function needs to be implemented for each parsing layer. It should return the correct packet name.
-    [[nodiscard]] virtual auto packet_name(const Output&) const -> std::string = 0;
+    /// This function needs to be implemented for each parsing layer. It should return the index of the packet type in
+    /// the packet type names that were passed to the constructor.
+    [[nodiscard]] virtual auto packet_type(const Output&) const -> std::size_t = 0;
 
-    /// This function take the currently parsed packet and should forward it to the next parsing stage or return a
-    /// unique pointer to it.
-    virtual auto forward(const Output&) -> std::unique_ptr<Output> = 0;
+    /// This function take the currently parsed packet and should move it to the next parsing stage or return a unique
+    /// pointer to it.
+    virtual auto forward(Output&&) -> std::unique_ptr<Output> = 0;
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+/// The categories of errors that are found while parsing malformed or truncated PDUs
+enum class ParseErrorCategory {
+    /// The PDU needed more bits than were available
+    kTruncated,
+    /// A field contained a reserved value
+    kReservedValue,
+    /// The PDU is not allowed on this logical channel or in this direction
+    kNotAllowed,
+    /// The PDU is valid, but parsing it is not implemented
+    kNotImplemented,
+    /// The length indication of the PDU does not match the available bits
+    kInvalidLength,
+};
+
+constexpr auto to_string(ParseErrorCategory category) noexcept -> const char* {
+    switch (category) {
+    case ParseErrorCategory::kTruncated:
+        return "Truncated";
+    case ParseErrorCategory::kReservedValue:
+        return "Reserved Value";
+    case ParseErrorCategory::kNotAllowed:
+        return "Not Allowed";
+    case ParseErrorCategory::kNotImplemented:
+        return "Not Implemented";
+    case ParseErrorCategory::kInvalidLength:
+        return "Invalid Length";
+    }
+};
+
+/// The number of parse error categories
+constexpr std::size_t kParseErrorCategoryCount = 5;
+
+/// An error that was found while parsing. The message is a string literal, so creating an error does not allocate.
+struct ParseError {
+    ParseErrorCategory category;
+    const char* message;
+};
+
+/// The result of a parser that does not throw. It holds either the parsed value or the error that was found.
+template <typename T> class ParseResult {
+  private:
+    std::variant<T, ParseError> value_or_error_;
+
+  public:
+    ParseResult() = delete;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    ParseResult(T&& value)
+        : value_or_error_(std::in_place_index<0>, std::move(value)){};
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    ParseResult(ParseError error)
+        : value_or_error_(std::in_place_index<1>, error){};
+
+    /// check if the parsing was successful
+    [[nodiscard]] auto has_value() const noexcept -> bool { return value_or_error_.index() == 0; };
+    explicit operator bool() const noexcept { return has_value(); };
+
+    /// get the error. may only be called if has_value() is false
+    [[nodiscard]] auto error() const -> const ParseError& { return std::get<1>(value_or_error_); };
+
+    /// get the parsed value. may only be called if has_value() is true
+    [[nodiscard]] auto operator*() & -> T& { return std::get<0>(value_or_error_); };
+    [[nodiscard]] auto operator*() && -> T&& { return std::get<0>(std::move(value_or_error_)); };
+    [[nodiscard]] auto operator->() -> T* { return &std::get<0>(value_or_error_); };
+
+    /// get the parsed value or throw the error as std::runtime_error for the callers that use exceptions
+    [[nodiscard]] auto value() && -> T {
+        if (!has_value()) {
+            throw std::runtime_error(error().message);
+        }
+        return std::get<0>(std::move(value_or_error_));
+    };
+};
@@ -9,11 +9,14 @@
 #pragma once
 
 #include "utils/bit_vector.hpp"
+#include <array>
 #include <cstddef>
-#include <map>
+#include <cstdint>
+#include <initializer_list>
 #include <optional>
-#include <set>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 template <std::size_t N> struct BitVectorElement {
   public:
@@ -40,14 +43,150 @@ inline auto operator<<(std::ostream& stream, const Type34Element& element) -> st
     return stream;
 };
 
+/// A set of type 3 or type 4 element identifiers. The identifiers are 4-bit values, so the set is stored as a 16-bit
+/// mask and can be created at compile time.
+template <typename ElementIdentifier> class Type34ElementIdentifierSet {
+  public:
+    constexpr Type34ElementIdentifierSet() = default;
+
+    // NOLINTNEXTLINE(google-explicit-constructor)
+    constexpr Type34ElementIdentifierSet(std::initializer_list<ElementIdentifier> element_identifiers) {
+        for (auto element_identifier : element_identifiers) {
+            mask_ |= bit(element_identifier);
+        }
+    };
+
+    /// check if the element identifier is contained in the set
+    [[nodiscard]] constexpr auto contains(ElementIdentifier element_identifier) const noexcept -> bool {
+        return (mask_ & bit(element_identifier)) != 0;
+    };
+
+  private:
+    [[nodiscard]] static constexpr auto bit(ElementIdentifier element_identifier) noexcept -> uint16_t {
+        return static_cast<uint16_t>(1U << static_cast<unsigned>(element_identifier));
+    };
+
+    uint16_t mask_ = 0;
+};
+
+/// The type 3 and type 4 elements of a packet indexed by their 4-bit element identifier. Only the present elements are
+/// stored in the order they were parsed. The first elements are stored inline, so the common packets with few optional
+/// elements are parsed without a heap allocation. A 16-bit mask marks the present element identifiers and a table
+/// holds the slot of each present element.
+template <typename ElementIdentifier> class Type34Elements {
+  private:
+    /// The number of possible element identifiers
+    static constexpr std::size_t kElementIdentifierCount = 16;
+    /// The number of elements that are stored without a heap allocation
+    static constexpr std::size_t kInlineElements = 4;
+
+    [[nodiscard]] static auto bit(ElementIdentifier element_identifier) -> uint16_t {
+        const auto index = static_cast<std::size_t>(element_identifier);
+        if (index >= kElementIdentifierCount) {
+            throw std::out_of_range("The element identifier is out of range.");
+        }
+        return static_cast<uint16_t>(1U << index);
+    };
+
+    /// the element in this slot
+    [[nodiscard]] auto element_in_slot(std::size_t slot) const noexcept -> const Type34Element& {
+        return slot < kInlineElements ? inline_elements_[slot] : overflow_elements_[slot - kInlineElements];
+    };
+
+    uint16_t mask_ = 0;
+    /// the slot of the element of each present element identifier
+    std::array<uint8_t, kElementIdentifierCount> slots_{};
+    /// the number of present elements
+    std::size_t size_ = 0;
+    std::array<Type34Element, kInlineElements> inline_elements_{};
+    /// the elements after the first kInlineElements
+    std::vector<Type34Element> overflow_elements_;
+
+  public:
+    /// Iterates over the present elements in order of their element identifier and returns pairs of the element
+    /// identifier and the element
+    class ConstIterator {
+      public:
+        ConstIterator(const Type34Elements& elements, uint16_t mask)
+            : elements_(elements)
+            , mask_(mask){};
+
+        auto operator*() const -> std::pair<ElementIdentifier, const Type34Element&> {
+            const auto index = static_cast<std::size_t>(__builtin_ctz(mask_));
+            return {ElementIdentifier(index), elements_.element_in_slot(elements_.slots_[index])};
+        };
+
+        auto operator++() -> ConstIterator& {
+            // clear the lowest present element identifier
+            mask_ &= mask_ - 1U;
+            return *this;
+        };
+
+        auto operator!=(const ConstIterator& other) const -> bool { return mask_ != other.mask_; };
+
+      private:
+        const Type34Elements& elements_;
+        /// the element identifiers that are not yet iterated over
+        uint16_t mask_;
+    };
+
+    /// check if an element with this identifier is present
+    [[nodiscard]] auto contains(ElementIdentifier element_identifier) const -> bool {
+        return (mask_ & bit(element_identifier)) != 0;
+    };
+
+    /// get the element with this identifier. throws if it is not present
+    [[nodiscard]] auto at(ElementIdentifier element_identifier) const -> const Type34Element& {
+        const auto element_bit = bit(element_identifier);
+        if ((mask_ & element_bit) == 0) {
+            throw std::out_of_range("This element identifier is not present.");
+        }
+        return element_in_slot(slots_[static_cast<std::size_t>(element_identifier)]);
+    };
+
+    /// insert the element with this identifier. throws if it is already present
+    auto insert(ElementIdentifier element_identifier, Type34Element&& element) -> void {
+        const auto element_bit = bit(element_identifier);
+        if ((mask_ & element_bit) != 0) {
+            throw std::runtime_error("This element identifier already occured.");
+        }
+        if (size_ < kInlineElements) {
+            inline_elements_[size_] = std::move(element);
+        } else {
+            overflow_elements_.emplace_back(std::move(element));
+        }
+        slots_[static_cast<std::size_t>(element_identifier)] = static_cast<uint8_t>(size_++);
+        mask_ |= element_bit;
+    };
+
+    [[nodiscard]] auto begin() const -> ConstIterator { return ConstIterator(*this, mask_); };
+    [[nodiscard]] auto end() const -> ConstIterator { return ConstIterator(*this, 0); };
+
+    /// The elements are serialized as an array of pairs of the element identifier and the element
+    friend void to_json(nlohmann::json& json, const Type34Elements& elements) {
+        json = nlohmann::json::array();
+        for (const auto& [key, value] : elements) {
+            json.push_back(nlohmann::json::array({key, value}));
+        }
+    };
+
+    friend void from_json(const nlohmann::json& json, Type34Elements& elements) {
+        elements = Type34Elements{};
+        for (const auto& entry : json) {
+            elements.insert(entry.at(0).template get<ElementIdentifier>(), entry.at(1).template get<Type34Element>());
+        }
+    };
+};
+
 template <typename ElementIdentifier> class Type234Parser {
   public:
-    using Map = std::map<ElementIdentifier, Type34Element>;
+    using Map = Type34Elements<ElementIdentifier>;
+    using ElementIdentifierSet = Type34ElementIdentifierSet<ElementIdentifier>;
 
     Type234Parser() = delete;
 
-    Type234Parser(BitVector& data, std::set<ElementIdentifier> allowed_type3_elements,
-                  std::set<ElementIdentifier> allowed_type4_elements)
+    Type234Parser(BitVector& data, ElementIdentifierSet allowed_type3_elements,
+                  ElementIdentifierSet allowed_type4_elements)
         // Extract the O-bit
         : present_(static_cast<bool>(data.take<1>()))
         , allowed_type3_elements_(allowed_type3_elements)
@@ -81,25 +220,19 @@ template <typename ElementIdentifier> class Type234Parser {
             auto element_identifier = ElementIdentifier(data.take<4>());
             auto length_indicator = data.take<11>();
             // Is this a type 3 element?
-            if (allowed_type3_elements_.count(element_identifier)) {
-                const auto element_data = data.take_vector(length_indicator);
-                if (elements.count(element_identifier)) {
-                    throw std::runtime_error("This element identifier already occured.");
-                }
-                elements[element_identifier] = Type34Element{.unparsed_bits = element_data};
+            if (allowed_type3_elements_.contains(element_identifier)) {
+                auto element_data = data.take_vector(length_indicator);
+                elements.insert(element_identifier, Type34Element{.unparsed_bits = std::move(element_data)});
                 continue;
             }
             // Is this a type 4 element?
-            if (allowed_type4_elements_.count(element_identifier)) {
+            if (allowed_type4_elements_.contains(element_identifier)) {
                 const auto repeated_elements = data.take<6>();
                 // The length_indicator is the "Total length of the following type 4 Elements in bits (including the
                 // Number of repeated elements)"
-                const auto element_data = data.take_vector(length_indicator - 6);
-                if (elements.count(element_identifier)) {
-                    throw std::runtime_error("This element identifier already occured.");
-                }
-                elements[element_identifier] =
-                    Type34Element{.unparsed_bits = element_data, .repeated_elements = repeated_elements};
+                auto element_data = data.take_vector(length_indicator - 6);
+                elements.insert(element_identifier, Type34Element{.unparsed_bits = std::move(element_data),
+                                                                  .repeated_elements = repeated_elements});
                 continue;
             }
             // Is this element invalid?
@@ -111,6 +244,6 @@ template <typename ElementIdentifier> class Type234Parser {
 
   private:
     bool present_ = false;
-    std::set<ElementIdentifier> allowed_type3_elements_;
-    std::set<ElementIdentifier> allowed_type4_elements_;
+    ElementIdentifierSet allowed_type3_elements_;
+    ElementIdentifierSet allowed_type4_elements_;
 };
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <fmt/color.h>
 #include <fmt/core.h>
 #include <fmt/format.h>
+#include <optional>
 
 void BitStreamDecoder::process_bit(uint8_t symbol) noexcept {
     assert(symbol <= 1);
@@ -26,48 +27,15 @@ void BitStreamDecoder::process_bit(uint8_t symbol) noexcept {
     }
 
     if (!is_uplink_) {
-        bool frame_found = false;
-        // XXX: this will only find Normal Continous Downlink Burst and
-        // Synchronization Continous Downlink Burst
-        uint32_t score_begin = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_3_BEGIN, 0);
-        uint32_t score_end = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_3_END, 500);
-
-        // frame (burst) is matched and can be processed
-        if ((score_begin == 0) && (score_end < 2)) {
-            frame_found = true;
-            // reset missing sync synchronizer
-            reset_synchronizer();
-        }
-
-        bool cleared_flag = false;
-
-        // the frame can be processed either by presence of
-        // training sequence, either by synchronized and
-        // still allowed missing frames
-        if (frame_found || (is_synchronized_ && ((sync_bit_counter_ % 510) == 0))) {
-            process_downlink_frame();
-
-            // frame has been processed, so clear it
-            frame_.clear();
-
-            // set flag to prevent erasing first bit in frame
-            cleared_flag = true;
-        }
-
-        sync_bit_counter_--;
-
-        // synchronization is lost
-        if (sync_bit_counter_ <= 0) {
-            printf("* synchronization lost\n");
-            is_synchronized_ = false;
-            sync_bit_counter_ = 0;
-        }
-
-        // remove first symbol from buffer to make space for next one
-        if (!cleared_flag) {
-            frame_.erase(frame_.begin());
+        if (is_synchronized_) {
+            track_downlink_burst();
+        } else {
+            search_downlink_burst();
         }
     } else {
+        uplink_bit_position_++;
+        uplink_burst_peak_picker_.advance(uplink_bit_position_);
+
         // check at the end
         auto score_ssn = pattern_at_position_score(frame_, kEXTENDED_TRAINING_SEQ, 88);
 
@@ -76,42 +44,104 @@ void BitStreamDecoder::process_bit(uint8_t symbol) noexcept {
 
         auto minimum_score = score_ssn;
         auto burst_type = BurstType::ControlUplinkBurst;
+        auto training_seq_length = kEXTENDED_TRAINING_SEQ.size();
 
         if (score_nub < minimum_score) {
             minimum_score = score_nub;
             burst_type = BurstType::NormalUplinkBurst;
+            training_seq_length = kNORMAL_TRAINING_SEQ_1.size();
         }
 
         if (score_nub_split < minimum_score) {
             minimum_score = score_nub_split;
             burst_type = BurstType::NormalUplinkBurstSplit;
+            training_seq_length = kNORMAL_TRAINING_SEQ_2.size();
         }
 
-        if (score_ssn <= 4) {
-            lower_mac_worker_queue_->queue_work(std::bind(&LowerMac::process, lower_mac_, frame_, burst_type));
+        if (score_ssn <= 4 || minimum_score <= 2) {
+            // valid burst found, the best detection out of the adjacent ones is sent to the lower MAC
+            auto quality = 1.0F - static_cast<float>(minimum_score) / static_cast<float>(training_seq_length);
+            uplink_burst_peak_picker_.detect(uplink_bit_position_, quality,
+                                             UplinkBurst{.burst_type = burst_type, .bits = frame_});
+        }
 
-            std::vector<uint8_t>(frame_.begin() + 200, frame_.end()).swap(frame_);
-        } else if (minimum_score <= 2) {
-            // valid burst found, send it to lower MAC
-            lower_mac_worker_queue_->queue_work(std::bind(&LowerMac::process, lower_mac_, frame_, burst_type));
+        frame_.erase(frame_.begin());
+    }
+}
 
+void BitStreamDecoder::search_downlink_burst() noexcept {
+    // XXX: this will only find Normal Continous Downlink Burst and
+    // Synchronization Continous Downlink Burst
+    if (is_downlink_burst_at_position(0)) {
+        reset_synchronizer();
+        process_downlink_frame(0);
+
+        // keep the last bits of this burst, the next burst is expected to start after them
+        frame_.erase(frame_.begin(), frame_.begin() + kFRAME_LEN - kTRACKING_WINDOW);
+        return;
+    }
+
+    // remove first symbol from buffer to make space for next one
+    frame_.erase(frame_.begin());
+}
+
+void BitStreamDecoder::track_downlink_burst() noexcept {
+    // wait until the next burst and the drift search window on both sides of it are received
+    if (frame_.size() < kFRAME_LEN + 2 * kTRACKING_WINDOW) {
+        return;
+    }
+
+    // search the training sequence around the expected position, starting in the middle to prefer no drift
+    std::optional<std::size_t> burst_position;
+    for (std::size_t distance = 0; distance <= kTRACKING_WINDOW && !burst_position; distance++) {
+        if (is_downlink_burst_at_position(kTRACKING_WINDOW - distance)) {
+            burst_position = kTRACKING_WINDOW - distance;
+        } else if (is_downlink_burst_at_position(kTRACKING_WINDOW + distance)) {
+            burst_position = kTRACKING_WINDOW + distance;
+        }
+    }
+
+    if (burst_position) {
+        reset_synchronizer();
+    } else {
+        missed_bursts_++;
+
+        // synchronization is lost
+        if (missed_bursts_ > kMAX_MISSED_BURSTS) {
+            printf("* synchronization lost\n");
+            is_synchronized_ = false;
+            missed_bursts_ = 0;
+            // continue with the full search
             frame_.erase(frame_.begin());
-            // std::vector<uint8_t>(frame_.begin()+462, frame_.end()).swap(frame_);
-        } else {
-            frame_.erase(frame_.begin());
+            return;
         }
     }
+
+    // the frame is processed either by presence of the training sequence or at the expected position while the
+    // synchronization allows missing bursts
+    const auto position = burst_position.value_or(kTRACKING_WINDOW);
+    process_downlink_frame(position);
+
+    // jump to the next burst boundary
+    frame_.erase(frame_.begin(), frame_.begin() + position + kFRAME_LEN - kTRACKING_WINDOW);
+}
+
+auto BitStreamDecoder::is_downlink_burst_at_position(const std::size_t position) const noexcept -> bool {
+    auto score_begin = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_3_BEGIN, position);
+    auto score_end = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_3_END, position + 500);
+
+    return (score_begin == 0) && (score_end < 2);
 }
 
 void BitStreamDecoder::reset_synchronizer() noexcept {
     is_synchronized_ = true;
-    sync_bit_counter_ = kFRAME_LEN * 50;
+    missed_bursts_ = 0;
 }
 
-void BitStreamDecoder::process_downlink_frame() noexcept {
-    auto score_sb = pattern_at_position_score(frame_, kSYNC_TRAINING_SEQ, 214);
-    auto score_ndb = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_1, 244);
-    auto score_ndb_split = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_2, 244);
+void BitStreamDecoder::process_downlink_frame(const std::size_t position) noexcept {
+    auto score_sb = pattern_at_position_score(frame_, kSYNC_TRAINING_SEQ, position + 214);
+    auto score_ndb = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_1, position + 244);
+    auto score_ndb_split = pattern_at_position_score(frame_, kNORMAL_TRAINING_SEQ_2, position + 244);
 
     auto minimum_score = score_sb;
     auto burst_type = BurstType::SynchronizationBurst;
@@ -128,7 +158,8 @@ void BitStreamDecoder::process_downlink_frame() noexcept {
 
     if (minimum_score <= 5) {
         // valid burst found, send it to lower MAC
-        lower_mac_worker_queue_->queue_work(std::bind(&LowerMac::process, lower_mac_, frame_, burst_type));
+        auto burst = std::vector<uint8_t>(frame_.cbegin() + position, frame_.cbegin() + position + kFRAME_LEN);
+        lower_mac_worker_queue_->queue_work(std::bind(&LowerMac::process, lower_mac_, std::move(burst), burst_type));
     }
 }
 
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "borzoi/borzoi_compression.hpp"
+#include <stdexcept>
+
+namespace {
+
+/// The base two logarithm of the zlib window size
+constexpr int kWindowBits = 15;
+/// The value added to the window bits to write a gzip instead of a zlib header
+constexpr int kGzipHeader = 16;
+/// The zlib memory level. 8 is the zlib default.
+constexpr int kMemoryLevel = 8;
+
+} // namespace
+
+auto borzoi_compression_from_string(const std::string& name) -> BorzoiCompression {
+    for (auto compression : {BorzoiCompression::kNone, BorzoiCompression::kGzip, BorzoiCompression::kDeflate}) {
+        if (name == to_string(compression)) {
+            return compression;
+        }
+    }
+    throw std::runtime_error("Unknown borzoi compression: " + name + ". Supported are none, gzip and deflate.");
+}
+
+auto BorzoiCompressor::check_level(const int level) -> void {
+    if (level < Z_DEFAULT_COMPRESSION || level > Z_BEST_COMPRESSION) {
+        throw std::runtime_error("The borzoi compression level must be between -1 and 9");
+    }
+}
+
+BorzoiCompressor::BorzoiCompressor(BorzoiCompression compression, int level)
+    : stream_(std::make_unique<z_stream>()) {
+    if (compression == BorzoiCompression::kNone) {
+        throw std::runtime_error("The borzoi compressor needs a compression");
+    }
+    check_level(level);
+
+    const auto window_bits = compression == BorzoiCompression::kGzip ? kWindowBits + kGzipHeader : kWindowBits;
+    if (deflateInit2(stream_.get(), level, Z_DEFLATED, window_bits, kMemoryLevel, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Failed to initialize the zlib stream of the borzoi compressor");
+    }
+}
+
+BorzoiCompressor::~BorzoiCompressor() { deflateEnd(stream_.get()); }
+
+auto BorzoiCompressor::compress(const std::string& body) -> std::string {
+    std::string compressed;
+    compressed.resize(deflateBound(stream_.get(), static_cast<uLong>(body.size())));
+
+    // zlib does not modify the input
+    stream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream_->avail_in = static_cast<uInt>(body.size());
+    stream_->next_out = reinterpret_cast<Bytef*>(compressed.data());
+    stream_->avail_out = static_cast<uInt>(compressed.size());
+
+    // the output buffer is large enough to compress the whole body in one call
+    const auto result = deflate(stream_.get(), Z_FINISH);
+    compressed.resize(compressed.size() - stream_->avail_out);
+    deflateReset(stream_.get());
+
+    if (result != Z_STREAM_END) {
+        throw std::runtime_error("Failed to compress the borzoi request body");
+    }
+
+    return compressed;
+}
@@ -7,26 +7,91 @@
  */
 
 #include "borzoi/borzoi_sender.hpp"
-#include "borzoi/borzoi_packets.hpp"
-#include "nlohmann/borzoi_send_tetra_packet.hpp"                        // IWYU pragma: keep
-#include "nlohmann/borzoi_send_tetra_slots.hpp"                         // IWYU pragma: keep
-#include "utils/ostream_std_unique_ptr_logical_link_control_packet.hpp" // IWYU pragma: keep
 #include <cpr/body.h>
 #include <cpr/cprtypes.h>
 #include <cpr/payload.h>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <stdexcept>
 #include <utility>
 
 #if defined(__linux__)
 #include <pthread.h>
 #endif
 
-BorzoiSender::BorzoiSender(ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue,
-                           std::atomic_bool& termination_flag, const std::string& borzoi_url, std::string borzoi_uuid)
-    : queue_(queue)
+auto BorzoiSender::check_options(const BorzoiSenderOptions& options) -> void {
+    if (options.batch_size == 0) {
+        throw std::runtime_error("The batch size of the borzoi sender must be at least one");
+    }
+    if (options.connection_count == 0) {
+        throw std::runtime_error("The borzoi sender needs at least one connection");
+    }
+    if (options.max_in_flight == 0) {
+        throw std::runtime_error("The borzoi sender needs to allow at least one request in flight");
+    }
+    if (options.compression != BorzoiCompression::kNone) {
+        BorzoiCompressor::check_level(options.compression_level);
+    }
+    if (options.spool_directory) {
+        BorzoiSpool::check_size(options.spool_max_bytes, options.spool_segment_bytes);
+    }
+}
+
+BorzoiSender::BorzoiSender(std::shared_ptr<OutputSinkQueue> queue, std::atomic_bool& termination_flag,
+                           const std::string& borzoi_url, const BorzoiSenderOptions& options,
+                           const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+    : queue_(std::move(queue))
     , termination_flag_(termination_flag)
-    , borzoi_url_sds_(borzoi_url + "/tetra")
-    , borzoi_url_failed_slots_(borzoi_url + "/tetra/failed_slots")
-    , borzoi_uuid_(std::move(borzoi_uuid)) {
+    , options_(options) {
+    check_options(options_);
+
+    if (options_.spool_directory) {
+        spool_ = std::make_unique<BorzoiSpool>(*options_.spool_directory, options_.spool_max_bytes,
+                                               options_.spool_segment_bytes, options_.spool_sync_policy,
+                                               prometheus_exporter);
+    }
+
+    if (prometheus_exporter) {
+        metrics_ = std::make_unique<BorzoiSenderMetrics>(prometheus_exporter);
+        for (auto endpoint : {BorzoiEndpoint::kPacket, BorzoiEndpoint::kFailedSlots}) {
+            endpoint_metrics_[static_cast<std::size_t>(endpoint)] =
+                std::make_unique<BorzoiEndpointMetrics>(prometheus_exporter, to_string(endpoint));
+        }
+    }
+
+    for (std::size_t i = 0; i < options_.connection_count; i++) {
+        auto connection = std::make_unique<Connection>();
+        connection->index = i;
+        connection->sessions[static_cast<std::size_t>(BorzoiEndpoint::kPacket)].SetUrl(
+            cpr::Url{borzoi_url + "/tetra"});
+        connection->sessions[static_cast<std::size_t>(BorzoiEndpoint::kFailedSlots)].SetUrl(
+            cpr::Url{borzoi_url + "/tetra/failed_slots"});
+        auto header = cpr::Header{{"Content-Type", content_type(options_.wire_format)}};
+        if (options_.compression != BorzoiCompression::kNone) {
+            connection->compressor =
+                std::make_unique<BorzoiCompressor>(options_.compression, options_.compression_level);
+            header.emplace("Content-Encoding", to_string(options_.compression));
+        }
+        for (auto& session : connection->sessions) {
+            session.SetHeader(header);
+        }
+        for (auto& batch : connection->batches) {
+            batch.packets.reserve(options_.batch_size);
+        }
+        connections_.emplace_back(std::move(connection));
+    }
+
+    for (std::size_t i = 0; i < connections_.size(); i++) {
+        auto& connection = *connections_[i];
+        connection.thread = std::thread(&BorzoiSender::connection_worker, this, std::ref(connection));
+
+#if defined(__linux__)
+        auto handle = connection.thread.native_handle();
+        pthread_setname_np(handle, ("BorzoiConn" + std::to_string(i)).c_str());
+#endif
+    }
+
     worker_thread_ = std::thread(&BorzoiSender::worker, this);
 
 #if defined(__linux__)
@@ -35,62 +100,398 @@ BorzoiSender::BorzoiSender(ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLi
 #endif
 }
 
-BorzoiSender::~BorzoiSender() { worker_thread_.join(); }
+BorzoiSender::~BorzoiSender() {
+    worker_thread_.join();
+    for (auto& connection : connections_) {
+        connection->thread.join();
+    }
+}
+
+auto BorzoiSender::send(const OutputPacket& packet) -> void {
+    // the json text is created once by the fan-out stage if any sink needs it
+    auto payload = options_.wire_format == BorzoiWireFormat::kJson && !packet.json_text.empty()
+                       ? packet.json_text
+                       : serialize_borzoi_packet(packet.json, options_.wire_format);
+
+    // packets with the same route (the same mobile station or the failed slots) are always sent on the same
+    // connection to keep them in order
+    dispatch(packet.endpoint, packet.route, std::move(payload));
+}
+
+auto BorzoiSender::spooling() -> bool {
+    return spool_ && (delivery_failing_.load() || queue_->size() > options_.spool_queue_threshold || !spool_->empty());
+}
+
+auto BorzoiSender::spool_live_requests() -> void {
+    // the requests on the connections hold older packets than the batches and the packets that are spooled next
+    {
+        std::unique_lock<std::mutex> lock(in_flight_mutex_);
+        in_flight_cv_.wait(lock, [this] { return in_flight_ == 0; });
+    }
+
+    process_completions();
+
+    for (auto& connection : connections_) {
+        for (auto endpoint : {BorzoiEndpoint::kPacket, BorzoiEndpoint::kFailedSlots}) {
+            spool_packets(endpoint, connection->index, connection->batches[static_cast<std::size_t>(endpoint)].packets);
+        }
+    }
+}
+
+auto BorzoiSender::process_completions() -> void {
+    // the connections return their requests in order
+    while (!completions_.empty()) {
+        auto completion = completions_.get_or_null();
+        auto& request = completion->request;
 
-void BorzoiSender::send_packet(const std::unique_ptr<LogicalLinkControlPacket>& packet) {
-    nlohmann::json json = BorzoiSendTetraPacket(packet, borzoi_uuid_);
+        if (request.replay_positions.empty()) {
+            spool_packets(request.endpoint, request.route, request.packets);
+            continue;
+        }
 
-    cpr::Response resp =
-        cpr::Post(borzoi_url_sds_, cpr::Body{json.dump()}, cpr::Header{{"Content-Type", "application/json"}});
+        auto& connection = *connections_[request.route % connections_.size()];
+        replay_in_flight_--;
+        if (--connection.replay_in_flight == 0) {
+            // no replayed request is left on the connection, the failed packets are sent again in order
+            connection.replay_failed = false;
+        }
+
+        auto state = ReplayRecord::State::kPending;
+        if (completion->result == RequestResult::kDelivered) {
+            delivery_failing_ = false;
+            state = ReplayRecord::State::kDelivered;
+        } else if (completion->result == RequestResult::kRejected) {
+            state = ReplayRecord::State::kDropped;
+        }
 
-    if (resp.status_code != 200) {
-        std::cout << "Failed to send packet to Borzoi: " << json.dump() << " Error: " << resp.status_code << " "
-                  << resp.error.message << std::endl;
+        // packets that were dropped from the spool in the meantime are no longer in the window
+        for (const auto position : request.replay_positions) {
+            if (position >= replay_window_position_ && position - replay_window_position_ < replay_window_.size()) {
+                replay_window_[position - replay_window_position_].state = state;
+            }
+        }
     }
+
+    commit_replayed();
 }
 
-void BorzoiSender::send_failed_slots(const Slots& slots) {
-    nlohmann::json json = BorzoiSendTetraSlots(slots, borzoi_uuid_);
+auto BorzoiSender::commit_replayed() -> void {
+    if (!spool_) {
+        return;
+    }
 
-    cpr::Response resp =
-        cpr::Post(borzoi_url_failed_slots_, cpr::Body{json.dump()}, cpr::Header{{"Content-Type", "application/json"}});
+    // the spool drops its oldest packets when it is full
+    const auto head = spool_->head();
+    while (!replay_window_.empty() && replay_window_position_ < head) {
+        replay_window_.pop_front();
+        replay_window_position_++;
+    }
+    if (replay_window_.empty()) {
+        replay_window_position_ = head;
+    }
+
+    while (!replay_window_.empty()) {
+        const auto state = replay_window_.front().state;
+        if (state != ReplayRecord::State::kDelivered && state != ReplayRecord::State::kDropped) {
+            break;
+        }
+
+        std::size_t records = 0;
+        while (!replay_window_.empty() && replay_window_.front().state == state) {
+            replay_window_.pop_front();
+            replay_window_position_++;
+            records++;
+        }
 
-    if (resp.status_code != 200) {
-        std::cout << "Failed to send packet to Borzoi: " << json.dump() << " Error: " << resp.status_code << " "
-                  << resp.error.message << std::endl;
+        if (state == ReplayRecord::State::kDelivered) {
+            spool_->commit(records);
+        } else {
+            spool_->drop(records);
+        }
     }
 }
 
-void BorzoiSender::worker() {
+auto BorzoiSender::spool_packets(BorzoiEndpoint endpoint, uint64_t route, std::vector<std::string>& packets) -> void {
+    for (auto& payload : packets) {
+        spool_->append(BorzoiSpoolRecord{
+            .endpoint = endpoint, .route = route, .format = options_.wire_format, .payload = std::move(payload)});
+    }
+    packets.clear();
+}
+
+auto BorzoiSender::dispatch(BorzoiEndpoint endpoint, uint64_t route, std::string&& payload) -> void {
+    // once a packet is in the spool, all following packets have to go through it to keep them in order
+    if (spooling()) {
+        spool_live_requests();
+        spool_->append(BorzoiSpoolRecord{
+            .endpoint = endpoint, .route = route, .format = options_.wire_format, .payload = std::move(payload)});
+        return;
+    }
+
+    enqueue(*connections_[route % connections_.size()], endpoint, std::move(payload));
+}
+
+auto BorzoiSender::replay_spool() -> void {
+    if (!spool_) {
+        return;
+    }
+
+    // keep enough packets in the window to fill all requests in flight
+    const auto window_size = options_.max_in_flight * options_.batch_size;
+    if (replay_window_.size() + options_.batch_size <= window_size) {
+        auto records = spool_->peek(window_size - replay_window_.size());
+        // the peek may have dropped a corrupt segment at the head of the spool
+        commit_replayed();
+
+        // the peeked packets follow the ones in the window
+        for (auto& record : records) {
+            auto state = ReplayRecord::State::kPending;
+            // the spool may hold packets of a previous run with a different wire format
+            if (record.format != options_.wire_format) {
+                try {
+                    record.payload = serialize_borzoi_packet(deserialize_borzoi_packet(record.payload, record.format),
+                                                             options_.wire_format);
+                } catch (const std::exception& e) {
+                    // the packet can never be sent, it is dropped from the spool
+                    std::cout << "Failed to convert a spooled packet from " << to_string(record.format) << " to "
+                              << to_string(options_.wire_format) << ": " << e.what() << std::endl;
+                    record.payload.clear();
+                    state = ReplayRecord::State::kDropped;
+                }
+            }
+            replay_window_.emplace_back(ReplayRecord{.endpoint = record.endpoint,
+                                                     .route = record.route,
+                                                     .payload = std::move(record.payload),
+                                                     .state = state});
+        }
+        commit_replayed();
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto probing = delivery_failing_.load();
+    if (probing && (replay_in_flight_ > 0 || now - last_replay_ < kSpoolProbeInterval)) {
+        return;
+    }
+    const auto max_requests = probing ? std::size_t{1} : options_.max_in_flight;
+
+    // one request for each connection and endpoint with its oldest pending packets
+    std::vector<Request> requests(connections_.size() * kBorzoiEndpointCount);
+    auto started = replay_in_flight_;
+    for (std::size_t i = 0; i < replay_window_.size(); i++) {
+        auto& record = replay_window_[i];
+        if (record.state != ReplayRecord::State::kPending) {
+            continue;
+        }
+
+        const auto connection_index = record.route % connections_.size();
+        if (connections_[connection_index]->replay_failed.load()) {
+            continue;
+        }
+
+        auto& request = requests[connection_index * kBorzoiEndpointCount + static_cast<std::size_t>(record.endpoint)];
+        if (request.packets.size() >= options_.batch_size) {
+            continue;
+        }
+        if (request.packets.empty()) {
+            if (started >= max_requests) {
+                continue;
+            }
+            started++;
+            request.endpoint = record.endpoint;
+            request.route = connection_index;
+        }
+
+        record.state = ReplayRecord::State::kSent;
+        request.packets.emplace_back(record.payload);
+        request.replay_positions.emplace_back(replay_window_position_ + i);
+    }
+
+    for (auto& request : requests) {
+        if (request.packets.empty()) {
+            continue;
+        }
+        // the packets are committed or sent again when the connection returns the request
+        auto& connection = *connections_[request.route];
+        connection.replay_in_flight++;
+        replay_in_flight_++;
+        last_replay_ = now;
+        connection.requests.push_back(std::move(request));
+    }
+}
+
+auto BorzoiSender::enqueue(Connection& connection, BorzoiEndpoint endpoint, std::string&& payload) -> void {
+    auto& batch = connection.batches[static_cast<std::size_t>(endpoint)];
+    if (batch.packets.empty()) {
+        batch.start = std::chrono::steady_clock::now();
+    }
+    batch.packets.emplace_back(std::move(payload));
+
+    if (batch.packets.size() >= options_.batch_size) {
+        flush(connection, endpoint);
+    }
+}
+
+auto BorzoiSender::flush_expired() -> void {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto& connection : connections_) {
+        for (auto endpoint : {BorzoiEndpoint::kPacket, BorzoiEndpoint::kFailedSlots}) {
+            const auto& batch = connection->batches[static_cast<std::size_t>(endpoint)];
+            if (!batch.packets.empty() && now - batch.start >= options_.batch_max_latency) {
+                flush(*connection, endpoint);
+            }
+        }
+    }
+}
+
+auto BorzoiSender::flush(Connection& connection, BorzoiEndpoint endpoint) -> void {
+    auto& batch = connection.batches[static_cast<std::size_t>(endpoint)];
+    if (batch.packets.empty()) {
+        return;
+    }
+
+    Request request{.endpoint = endpoint, .route = connection.index, .packets = std::move(batch.packets)};
+    batch.packets.clear();
+    batch.packets.reserve(options_.batch_size);
+
+    // wait until a request slot is available
+    {
+        std::unique_lock<std::mutex> lock(in_flight_mutex_);
+        in_flight_cv_.wait(lock, [this] { return in_flight_ < options_.max_in_flight; });
+        in_flight_++;
+        if (metrics_) {
+            metrics_->set_in_flight(in_flight_);
+        }
+    }
+
+    connection.requests.push_back(std::move(request));
+}
+
+auto BorzoiSender::post(Connection& connection, const Request& request) -> RequestResult {
+    auto& session = connection.sessions[static_cast<std::size_t>(request.endpoint)];
+
+    auto body = options_.batch_size == 1 ? request.packets.front()
+                                         : serialize_borzoi_batch(request.packets, options_.wire_format);
+    const auto raw_bytes = body.size();
+    if (connection.compressor) {
+        body = connection.compressor->compress(body);
+    }
+    const auto sent_bytes = body.size();
+
+    const auto start = std::chrono::steady_clock::now();
+    session.SetBody(cpr::Body{std::move(body)});
+    cpr::Response resp = session.Post();
+
+    if (const auto& metrics = endpoint_metrics_[static_cast<std::size_t>(request.endpoint)]) {
+        metrics->observe_request(request.packets.size(), std::chrono::steady_clock::now() - start);
+        metrics->observe_body(raw_bytes, sent_bytes);
+    }
+
+    if (resp.status_code == 200) {
+        return RequestResult::kDelivered;
+    }
+
+    // the request can succeed later if borzoi was not reachable or overloaded. the worker thread writes its packets to
+    // the spool.
+    const auto retriable = resp.status_code == 0 || resp.status_code == 429 || resp.status_code >= 500;
+    if (spool_ && retriable) {
+        return RequestResult::kFailed;
+    }
+
+    for (const auto& payload : request.packets) {
+        queue_->report_delivery_failed();
+        std::cout << "Failed to send packet to Borzoi: ";
+        if (options_.wire_format == BorzoiWireFormat::kJson) {
+            std::cout << payload;
+        } else {
+            std::cout << payload.size() << " bytes of " << to_string(options_.wire_format);
+        }
+        std::cout << " Error: " << resp.status_code << " " << resp.error.message << std::endl;
+    }
+
+    return retriable ? RequestResult::kFailed : RequestResult::kRejected;
+}
+
+void BorzoiSender::connection_worker(Connection& connection) {
     for (;;) {
-        const auto return_value = queue_.get_or_null();
+        auto request = connection.requests.get_or_null();
 
-        if (!return_value) {
-            if (termination_flag_.load() && queue_.empty()) {
+        if (!request) {
+            if (connection_termination_flag_.load() && connection.requests.empty()) {
                 break;
             }
 
             continue;
         }
 
-        std::visit(
-            [this](const auto& arg) {
-                using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, std::unique_ptr<LogicalLinkControlPacket>>) {
-                    send_packet(arg);
-
-                    // Do not log acknowledgements
-                    if (arg->basic_link_information_ &&
-                        (arg->basic_link_information_->basic_link_type_ == BasicLinkType::kBlAckWithoutFcs ||
-                         arg->basic_link_information_->basic_link_type_ == BasicLinkType::kBlAckWithFcs)) {
-                        return;
-                    }
-                    // std::cout << arg << std::endl;
-                } else if constexpr (std::is_same_v<T, Slots>) {
-                    /// send out the slots which had an error while parsing
-                    send_failed_slots(arg);
+        // after a failure the queued requests are returned without sending them, they are spooled or replayed again
+        // in order
+        const auto replay = !request->replay_positions.empty();
+        const auto skip = replay ? connection.replay_failed.load() : delivery_failing_.load();
+        const auto result = skip ? RequestResult::kFailed : post(connection, *request);
+
+        if (spool_ && (replay || result == RequestResult::kFailed)) {
+            if (result == RequestResult::kFailed) {
+                delivery_failing_ = true;
+                if (replay) {
+                    connection.replay_failed = true;
+                }
+            }
+            completions_.push_back(Completion{.request = std::move(*request), .result = result});
+            if (replay) {
+                continue;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(in_flight_mutex_);
+            in_flight_--;
+            if (metrics_) {
+                metrics_->set_in_flight(in_flight_);
+            }
+        }
+        in_flight_cv_.notify_one();
+    }
+}
+
+void BorzoiSender::worker() {
+    for (;;) {
+        const auto packet = queue_->get_or_null();
+
+        if (spooling()) {
+            spool_live_requests();
+        }
+        replay_spool();
+        flush_expired();
+
+        if (metrics_) {
+            std::size_t batched = 0;
+            for (const auto& connection : connections_) {
+                for (const auto& batch : connection->batches) {
+                    batched += batch.packets.size();
+                }
+            }
+            metrics_->set_backlog(queue_->size(), batched);
+        }
+
+        if (!packet) {
+            if (termination_flag_.load() && queue_->empty()) {
+                for (auto& connection : connections_) {
+                    flush(*connection, BorzoiEndpoint::kPacket);
+                    flush(*connection, BorzoiEndpoint::kFailedSlots);
                 }
-            },
-            *return_value);
+                // requests that fail while terminating are written to the spool
+                if (spool_) {
+                    spool_live_requests();
+                }
+                break;
+            }
+
+            continue;
+        }
+
+        send(*packet);
     }
-}
\ No newline at end of file
+
+    // all requests are queued on the connections. let them finish their work.
+    connection_termination_flag_ = true;
+}
@@ -0,0 +1,484 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "borzoi/borzoi_spool.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <zlib.h>
+
+namespace {
+
+/// The prefix of the names of the segment files
+constexpr const char* kSegmentPrefix = "segment-";
+/// The suffix of the names of the segment files
+constexpr const char* kSegmentSuffix = ".wal";
+/// The number of digits of the sequence number in the names of the segment files
+constexpr std::size_t kSequenceDigits = 20;
+
+/// The size of the header of a record: the length and the CRC32 of the content
+constexpr std::size_t kHeaderBytes = 8;
+/// The size of the fixed fields in the content of a record: the endpoint, the wire format and the route
+constexpr std::size_t kFixedContentBytes = 10;
+
+/// Write a value in little endian byte order
+template <typename T> auto put_le(std::string& buffer, T value) -> void {
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        buffer.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/// Read a value in little endian byte order
+template <typename T> auto get_le(const char* data) -> T {
+    T value = 0;
+    for (std::size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+auto crc_of(const char* data, std::size_t size) -> uint32_t {
+    return crc32(0L, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(size));
+}
+
+/// Serialize a record with its header
+auto encode(const BorzoiSpoolRecord& record) -> std::string {
+    std::string content;
+    content.reserve(kFixedContentBytes + record.payload.size());
+    put_le<uint8_t>(content, static_cast<uint8_t>(record.endpoint));
+    put_le<uint8_t>(content, static_cast<uint8_t>(record.format));
+    put_le<uint64_t>(content, record.route);
+    content += record.payload;
+
+    std::string buffer;
+    buffer.reserve(kHeaderBytes + content.size());
+    put_le<uint32_t>(buffer, static_cast<uint32_t>(content.size()));
+    put_le<uint32_t>(buffer, crc_of(content.data(), content.size()));
+    buffer += content;
+    return buffer;
+}
+
+/// Deserialize the content of a record
+auto decode(const char* content, std::size_t size) -> std::optional<BorzoiSpoolRecord> {
+    if (size < kFixedContentBytes) {
+        return std::nullopt;
+    }
+    const auto endpoint = get_le<uint8_t>(content);
+    const auto format = get_le<uint8_t>(content + 1);
+    if (endpoint >= kBorzoiEndpointCount || format > static_cast<uint8_t>(BorzoiWireFormat::kMessagePack)) {
+        return std::nullopt;
+    }
+    return BorzoiSpoolRecord{.endpoint = static_cast<BorzoiEndpoint>(endpoint),
+                             .route = get_le<uint64_t>(content + 2),
+                             .format = static_cast<BorzoiWireFormat>(format),
+                             .payload = std::string(content + kFixedContentBytes, size - kFixedContentBytes)};
+}
+
+/// Check the header and the CRC32 of the record at the offset
+/// \return the size of the record including the header if it is valid
+auto valid_record_size(const std::string& data, std::size_t offset) -> std::optional<std::size_t> {
+    if (data.size() - offset < kHeaderBytes) {
+        return std::nullopt;
+    }
+    const auto length = get_le<uint32_t>(data.data() + offset);
+    const auto crc = get_le<uint32_t>(data.data() + offset + 4);
+    if (length < kFixedContentBytes || data.size() - offset - kHeaderBytes < length) {
+        return std::nullopt;
+    }
+    if (crc_of(data.data() + offset + kHeaderBytes, length) != crc) {
+        return std::nullopt;
+    }
+    return kHeaderBytes + length;
+}
+
+/// Write the whole buffer to the file descriptor
+auto write_all(int fd, const std::string& buffer) -> bool {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        const auto result = write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+/// Read exactly size bytes from the file descriptor at the offset
+auto read_all(int fd, char* data, std::size_t size, std::size_t offset) -> bool {
+    std::size_t done = 0;
+    while (done < size) {
+        const auto result = pread(fd, data + done, size - done, static_cast<off_t>(offset + done));
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(result);
+    }
+    return true;
+}
+
+} // namespace
+
+auto borzoi_spool_sync_policy_from_string(const std::string& name) -> BorzoiSpoolSyncPolicy {
+    for (auto policy :
+         {BorzoiSpoolSyncPolicy::kNone, BorzoiSpoolSyncPolicy::kSegment, BorzoiSpoolSyncPolicy::kAlways}) {
+        if (name == to_string(policy)) {
+            return policy;
+        }
+    }
+    throw std::runtime_error("Unknown spool sync policy: " + name +
+                             ". Supported policies are none, segment and always.");
+}
+
+auto BorzoiSpool::check_size(const std::size_t max_bytes, const std::size_t segment_bytes) -> void {
+    if (segment_bytes == 0 || max_bytes < 2 * segment_bytes) {
+        throw std::runtime_error("The spool must be able to hold at least two segments");
+    }
+}
+
+BorzoiSpool::BorzoiSpool(std::string directory, std::size_t max_bytes, std::size_t segment_bytes,
+                         BorzoiSpoolSyncPolicy sync_policy,
+                         const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+    : directory_(std::move(directory))
+    , max_bytes_(max_bytes)
+    , segment_bytes_(segment_bytes)
+    , sync_policy_(sync_policy) {
+    check_size(max_bytes_, segment_bytes_);
+
+    if (prometheus_exporter) {
+        metrics_ = std::make_unique<BorzoiSpoolMetrics>(prometheus_exporter);
+    }
+
+    std::filesystem::create_directories(directory_);
+    recover();
+    update_size_metrics();
+}
+
+BorzoiSpool::~BorzoiSpool() {
+    if (read_fd_ >= 0) {
+        close(read_fd_);
+    }
+    if (write_fd_ >= 0) {
+        if (sync_policy_ != BorzoiSpoolSyncPolicy::kNone) {
+            fdatasync(write_fd_);
+        }
+        close(write_fd_);
+    }
+
+    // nothing left to replay. remove the segments so they are not scanned on the next start.
+    if (total_records_ == 0) {
+        for (const auto& segment : segments_) {
+            unlink(segment.path.c_str());
+        }
+    }
+}
+
+auto BorzoiSpool::recover() -> void {
+    std::vector<std::pair<uint64_t, std::string>> files;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        const auto name = entry.path().filename().string();
+        const auto prefix = std::string(kSegmentPrefix);
+        const auto suffix = std::string(kSegmentSuffix);
+        if (name.size() != prefix.size() + kSequenceDigits + suffix.size() || name.rfind(prefix, 0) != 0 ||
+            name.compare(prefix.size() + kSequenceDigits, suffix.size(), suffix) != 0) {
+            continue;
+        }
+        const auto digits = name.substr(prefix.size(), kSequenceDigits);
+        if (!std::all_of(digits.cbegin(), digits.cend(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        files.emplace_back(std::stoull(digits), entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto& [sequence, path] : files) {
+        next_sequence_ = sequence + 1;
+
+        std::ifstream file(path, std::ios::binary);
+        const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        // count the valid records. a partially written record at the end is ignored.
+        Segment segment{.path = path};
+        while (auto size = valid_record_size(data, segment.bytes)) {
+            segment.bytes += *size;
+            segment.records++;
+        }
+
+        if (segment.records == 0) {
+            unlink(path.c_str());
+            continue;
+        }
+
+        // cut off a partially written record so it is not counted or read
+        if (segment.bytes < data.size()) {
+            std::filesystem::resize_file(path, segment.bytes);
+        }
+
+        total_bytes_ += segment.bytes;
+        total_records_ += segment.records;
+        segments_.emplace_back(std::move(segment));
+    }
+}
+
+auto BorzoiSpool::start_segment() -> void {
+    if (write_fd_ >= 0) {
+        if (sync_policy_ != BorzoiSpoolSyncPolicy::kNone) {
+            fdatasync(write_fd_);
+        }
+        close(write_fd_);
+        write_fd_ = -1;
+    }
+
+    auto sequence = std::to_string(next_sequence_++);
+    sequence.insert(0, kSequenceDigits - sequence.size(), '0');
+    const auto path = (std::filesystem::path(directory_) / (kSegmentPrefix + sequence + kSegmentSuffix)).string();
+
+    write_fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, S_IRUSR | S_IWUSR | S_IRGRP);
+    if (write_fd_ < 0) {
+        throw std::runtime_error("Couldn't create spool segment " + path + ": " + std::strerror(errno));
+    }
+    segments_.emplace_back(Segment{.path = path});
+}
+
+auto BorzoiSpool::remove_oldest_segment() -> std::size_t {
+    auto& segment = segments_.front();
+    if (read_fd_ >= 0) {
+        close(read_fd_);
+        read_fd_ = -1;
+    }
+    read_offset_ = 0;
+    // the peeked records are always in the oldest segment
+    peeked_sizes_.clear();
+    peek_offset_ = 0;
+
+    unlink(segment.path.c_str());
+    const auto records = segment.records;
+    total_bytes_ -= segment.bytes;
+    total_records_ -= records;
+    removed_records_ += records;
+    segments_.pop_front();
+
+    return records;
+}
+
+auto BorzoiSpool::skip_oldest_segment() -> std::size_t {
+    auto& segment = segments_.front();
+    read_offset_ = segment.bytes;
+    peeked_sizes_.clear();
+    peek_offset_ = segment.bytes;
+
+    const auto records = segment.records;
+    total_records_ -= records;
+    removed_records_ += records;
+    segment.records = 0;
+
+    return records;
+}
+
+auto BorzoiSpool::append(const BorzoiSpoolRecord& record) -> void {
+    const auto buffer = encode(record);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (buffer.size() > max_bytes_) {
+        if (metrics_) {
+            metrics_->increment_dropped(1);
+        }
+        return;
+    }
+
+    if (write_fd_ < 0 || (segments_.back().bytes > 0 && segments_.back().bytes + buffer.size() > segment_bytes_)) {
+        start_segment();
+    }
+
+    // make room by dropping the oldest segments. the segment that is written is never dropped.
+    std::size_t dropped = 0;
+    while (total_bytes_ + buffer.size() > max_bytes_ && segments_.size() > 1) {
+        dropped += remove_oldest_segment();
+    }
+    if (dropped > 0) {
+        std::cout << "Borzoi spool is full. Dropped " << dropped << " packets." << std::endl;
+        if (metrics_) {
+            metrics_->increment_dropped(dropped);
+        }
+    }
+
+    if (!write_all(write_fd_, buffer)) {
+        std::cout << "Failed to write to the borzoi spool: " << std::strerror(errno) << std::endl;
+        if (metrics_) {
+            metrics_->increment_dropped(1);
+        }
+        // the segment may contain a partial record now. do not append to it anymore.
+        close(write_fd_);
+        write_fd_ = -1;
+        return;
+    }
+    if (sync_policy_ == BorzoiSpoolSyncPolicy::kAlways) {
+        fdatasync(write_fd_);
+    }
+
+    segments_.back().bytes += buffer.size();
+    segments_.back().records++;
+    total_bytes_ += buffer.size();
+    total_records_++;
+
+    if (metrics_) {
+        metrics_->increment_written();
+    }
+    update_size_metrics();
+}
+
+auto BorzoiSpool::peek(std::size_t max_records) -> std::vector<BorzoiSpoolRecord> {
+    std::vector<BorzoiSpoolRecord> records;
+    if (max_records == 0) {
+        return records;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::size_t dropped = 0;
+    while (records.empty() && !segments_.empty()) {
+        auto& segment = segments_.front();
+
+        if (read_offset_ >= segment.bytes) {
+            if (write_fd_ >= 0 && segments_.size() == 1) {
+                break;
+            }
+            // the segment is committed completely
+            dropped += remove_oldest_segment();
+            continue;
+        }
+
+        if (read_fd_ < 0) {
+            read_fd_ = open(segment.path.c_str(), O_RDONLY);
+            if (read_fd_ < 0) {
+                std::cout << "Failed to open the borzoi spool segment " << segment.path << ": " << std::strerror(errno)
+                          << std::endl;
+                dropped += skip_oldest_segment();
+                continue;
+            }
+        }
+
+        // the records after the peeked ones are read. the next segment is only read once this one is committed.
+        if (!peeked_sizes_.empty() && peek_offset_ >= segment.bytes) {
+            break;
+        }
+
+        while (records.size() < max_records && peek_offset_ < segment.bytes) {
+            std::array<char, kHeaderBytes> header{};
+            std::string content;
+            auto valid = read_all(read_fd_, header.data(), header.size(), peek_offset_);
+            if (valid) {
+                content.resize(get_le<uint32_t>(header.data()));
+                valid = peek_offset_ + kHeaderBytes + content.size() <= segment.bytes &&
+                        read_all(read_fd_, content.data(), content.size(), peek_offset_ + kHeaderBytes) &&
+                        crc_of(content.data(), content.size()) == get_le<uint32_t>(header.data() + 4);
+            }
+            auto record = valid ? decode(content.data(), content.size()) : std::nullopt;
+            if (!record) {
+                // the corrupt record is dropped once the records before it are committed
+                break;
+            }
+
+            peek_offset_ += kHeaderBytes + content.size();
+            peeked_sizes_.push_back(kHeaderBytes + content.size());
+            records.emplace_back(std::move(*record));
+        }
+
+        if (records.empty()) {
+            if (!peeked_sizes_.empty()) {
+                break;
+            }
+            // the segment is corrupt at the head of the spool. skip the rest of it.
+            dropped += skip_oldest_segment();
+        }
+    }
+
+    if (dropped > 0) {
+        if (metrics_) {
+            metrics_->increment_dropped(dropped);
+        }
+        update_size_metrics();
+    }
+
+    return records;
+}
+
+auto BorzoiSpool::remove_peeked(std::size_t records) -> std::size_t {
+    records = std::min(records, peeked_sizes_.size());
+    if (records == 0) {
+        return 0;
+    }
+
+    for (std::size_t i = 0; i < records; i++) {
+        read_offset_ += peeked_sizes_[i];
+    }
+    peeked_sizes_.erase(peeked_sizes_.begin(), peeked_sizes_.begin() + static_cast<std::ptrdiff_t>(records));
+    segments_.front().records -= records;
+    total_records_ -= records;
+    removed_records_ += records;
+
+    // delete the oldest segment as soon as it is committed completely
+    if (read_offset_ >= segments_.front().bytes && !(write_fd_ >= 0 && segments_.size() == 1)) {
+        remove_oldest_segment();
+    }
+
+    update_size_metrics();
+    return records;
+}
+
+auto BorzoiSpool::commit(std::size_t records) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    records = remove_peeked(records);
+    if (metrics_ && records > 0) {
+        metrics_->increment_replayed(records);
+    }
+}
+
+auto BorzoiSpool::drop(std::size_t records) -> void {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    records = remove_peeked(records);
+    if (metrics_ && records > 0) {
+        metrics_->increment_dropped(records);
+    }
+}
+
+auto BorzoiSpool::head() -> uint64_t {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return removed_records_;
+}
+
+auto BorzoiSpool::empty() -> bool {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return total_records_ == 0;
+}
+
+auto BorzoiSpool::update_size_metrics() -> void {
+    if (metrics_) {
+        metrics_->set_size(total_bytes_, total_records_);
+    }
+}
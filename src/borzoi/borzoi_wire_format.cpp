@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "borzoi/borzoi_wire_format.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace {
+
+/// Write a value in big endian byte order
+template <typename T> auto put_be(std::string& buffer, T value) -> void {
+    for (std::size_t i = sizeof(T); i > 0; i--) {
+        buffer.push_back(static_cast<char>((value >> (8 * (i - 1))) & 0xFF));
+    }
+}
+
+/// The header of a CBOR array (major type 4) of the given size
+auto cbor_array_header(std::string& buffer, std::size_t size) -> void {
+    if (size < 24) {
+        buffer.push_back(static_cast<char>(0x80 + size));
+    } else if (size <= UINT8_MAX) {
+        buffer.push_back(static_cast<char>(0x98));
+        put_be(buffer, static_cast<uint8_t>(size));
+    } else if (size <= UINT16_MAX) {
+        buffer.push_back(static_cast<char>(0x99));
+        put_be(buffer, static_cast<uint16_t>(size));
+    } else if (size <= UINT32_MAX) {
+        buffer.push_back(static_cast<char>(0x9A));
+        put_be(buffer, static_cast<uint32_t>(size));
+    } else {
+        buffer.push_back(static_cast<char>(0x9B));
+        put_be(buffer, static_cast<uint64_t>(size));
+    }
+}
+
+/// The header of a MessagePack array of the given size
+auto message_pack_array_header(std::string& buffer, std::size_t size) -> void {
+    if (size < 16) {
+        buffer.push_back(static_cast<char>(0x90 | size));
+    } else if (size <= UINT16_MAX) {
+        buffer.push_back(static_cast<char>(0xDC));
+        put_be(buffer, static_cast<uint16_t>(size));
+    } else if (size <= UINT32_MAX) {
+        buffer.push_back(static_cast<char>(0xDD));
+        put_be(buffer, static_cast<uint32_t>(size));
+    } else {
+        throw std::runtime_error("A MessagePack array can not hold more than 2^32-1 elements");
+    }
+}
+
+} // namespace
+
+auto borzoi_wire_format_from_string(const std::string& name) -> BorzoiWireFormat {
+    for (auto format : {BorzoiWireFormat::kJson, BorzoiWireFormat::kCbor, BorzoiWireFormat::kMessagePack}) {
+        if (name == to_string(format)) {
+            return format;
+        }
+    }
+    throw std::runtime_error("Unknown borzoi wire format: " + name + ". Supported formats are json, cbor and msgpack.");
+}
+
+auto serialize_borzoi_packet(const nlohmann::json& json, BorzoiWireFormat format) -> std::string {
+    std::string payload;
+    switch (format) {
+    case BorzoiWireFormat::kJson:
+        payload = json.dump();
+        break;
+    case BorzoiWireFormat::kCbor:
+        nlohmann::json::to_cbor(json, payload);
+        break;
+    case BorzoiWireFormat::kMessagePack:
+        nlohmann::json::to_msgpack(json, payload);
+        break;
+    }
+    return payload;
+}
+
+auto deserialize_borzoi_packet(const std::string& payload, BorzoiWireFormat format) -> nlohmann::json {
+    switch (format) {
+    case BorzoiWireFormat::kJson:
+        return nlohmann::json::parse(payload);
+    case BorzoiWireFormat::kCbor:
+        return nlohmann::json::from_cbor(payload);
+    case BorzoiWireFormat::kMessagePack:
+        return nlohmann::json::from_msgpack(payload);
+    }
+    throw std::runtime_error("Unknown borzoi wire format");
+}
+
+auto serialize_borzoi_batch(const std::vector<std::string>& packets, BorzoiWireFormat format) -> std::string {
+    std::size_t size = packets.size() + 9;
+    for (const auto& packet : packets) {
+        size += packet.size();
+    }
+
+    std::string body;
+    body.reserve(size);
+
+    switch (format) {
+    case BorzoiWireFormat::kJson:
+        body += "[";
+        for (const auto& packet : packets) {
+            if (body.size() > 1) {
+                body += ",";
+            }
+            body += packet;
+        }
+        body += "]";
+        return body;
+    case BorzoiWireFormat::kCbor:
+        cbor_array_header(body, packets.size());
+        break;
+    case BorzoiWireFormat::kMessagePack:
+        message_pack_array_header(body, packets.size());
+        break;
+    }
+
+    // the binary formats are self-delimiting, the elements directly follow the header
+    for (const auto& packet : packets) {
+        body += packet;
+    }
+    return body;
+}
@@ -0,0 +1,188 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "datagram_sink.hpp"
+#include <cerrno>
+#include <cstring>
+#include <netdb.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+namespace {
+
+/// The prefix of destinations that are Unix datagram sockets
+constexpr const char* kUnixPrefix = "unix:";
+
+/// Connect the socket to the Unix datagram socket at the path
+auto connect_unix(int fd, const std::string& path) -> bool {
+    struct sockaddr_un addr {};
+    addr.sun_family = AF_UNIX;
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    return connect(fd, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == 0;
+}
+
+/// A destination of the datagrams
+struct Destination {
+    /// the path of the Unix datagram socket or empty for UDP
+    std::string unix_path;
+    /// the host and port of the UDP destination
+    std::string host;
+    std::string port;
+};
+
+/// Parse the destination of the datagrams from its command line representation
+auto parse_destination(const std::string& destination) -> Destination {
+    if (destination.rfind(kUnixPrefix, 0) == 0) {
+        auto unix_path = destination.substr(std::strlen(kUnixPrefix));
+        if (unix_path.empty() || unix_path.size() >= sizeof(sockaddr_un::sun_path)) {
+            throw std::runtime_error("Invalid path of the Unix datagram socket: " + unix_path);
+        }
+        return Destination{.unix_path = std::move(unix_path)};
+    }
+
+    if (const auto separator = destination.rfind(':'); separator != std::string::npos) {
+        // IPv6 addresses are written in brackets: [::1]:42100
+        auto host = destination.substr(0, separator);
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+            host = host.substr(1, host.size() - 2);
+        }
+        return Destination{.host = std::move(host), .port = destination.substr(separator + 1)};
+    }
+
+    return Destination{.host = "localhost", .port = destination};
+}
+
+/// Resolve the addresses of the host and port. The result must be freed with freeaddrinfo.
+auto resolve_udp(const std::string& host, const std::string& port) -> struct addrinfo* {
+    struct addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_DGRAM;
+    hints.ai_protocol = IPPROTO_UDP;
+
+    struct addrinfo* result = nullptr;
+    if (const auto error = getaddrinfo(host.c_str(), port.c_str(), &hints, &result); error != 0) {
+        throw std::runtime_error("Couldn't resolve the UDP destination " + host + ":" + port + ": " +
+                                 gai_strerror(error));
+    }
+    return result;
+}
+
+/// Create a UDP socket connected to the host and port
+auto connect_udp(const std::string& host, const std::string& port) -> int {
+    auto* result = resolve_udp(host, port);
+
+    int fd = -1;
+    for (auto* address = result; address != nullptr; address = address->ai_next) {
+        fd = socket(address->ai_family, address->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, address->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+            break;
+        }
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd < 0) {
+        throw std::runtime_error("Couldn't create the UDP socket to " + host + ":" + port);
+    }
+    return fd;
+}
+
+} // namespace
+
+DatagramSink::DatagramSink(const std::string& destination, std::shared_ptr<OutputSinkQueue> queue,
+                           std::atomic_bool& termination_flag)
+    : queue_(std::move(queue))
+    , termination_flag_(termination_flag) {
+    auto parsed_destination = parse_destination(destination);
+    if (!parsed_destination.unix_path.empty()) {
+        unix_path_ = std::move(parsed_destination.unix_path);
+        fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) {
+            throw std::runtime_error("Couldn't create the Unix datagram socket");
+        }
+        // the consumer may create its socket later. it is connected when sending.
+        connect_unix(fd_, unix_path_);
+    } else {
+        fd_ = connect_udp(parsed_destination.host, parsed_destination.port);
+    }
+
+    worker_thread_ = std::thread(&DatagramSink::worker, this);
+
+#if defined(__linux__)
+    auto handle = worker_thread_.native_handle();
+    pthread_setname_np(handle, "DatagramSink");
+#endif
+}
+
+auto DatagramSink::check_destination(const std::string& destination) -> void {
+    const auto parsed_destination = parse_destination(destination);
+    if (parsed_destination.unix_path.empty()) {
+        freeaddrinfo(resolve_udp(parsed_destination.host, parsed_destination.port));
+    }
+}
+
+DatagramSink::~DatagramSink() {
+    worker_thread_.join();
+    close(fd_);
+}
+
+auto DatagramSink::worker() -> void {
+    for (;;) {
+        const auto packet = queue_->get_or_null();
+
+        if (!packet) {
+            if (termination_flag_.load() && queue_->empty()) {
+                break;
+            }
+
+            continue;
+        }
+
+        if (!send(packet->json_text)) {
+            queue_->report_delivery_failed();
+        }
+    }
+}
+
+auto DatagramSink::reconnect_unix() -> bool {
+    // a connected datagram socket is disconnected by connecting to AF_UNSPEC
+    struct sockaddr addr {};
+    addr.sa_family = AF_UNSPEC;
+    connect(fd_, &addr, sizeof(addr));
+
+    return connect_unix(fd_, unix_path_);
+}
+
+auto DatagramSink::send(const std::string& json_text) -> bool {
+    const auto size = static_cast<ssize_t>(json_text.size());
+    if (::send(fd_, json_text.data(), json_text.size(), MSG_DONTWAIT | MSG_NOSIGNAL) == size) {
+        return true;
+    }
+
+    // the Unix datagram socket of the consumer did not exist yet or was created again
+    if (!unix_path_.empty() && (errno == ENOTCONN || errno == ECONNREFUSED || errno == EDESTADDRREQ) &&
+        reconnect_unix()) {
+        return ::send(fd_, json_text.data(), json_text.size(), MSG_DONTWAIT | MSG_NOSIGNAL) == size;
+    }
+
+    // ECONNREFUSED: nobody listens on the port, EAGAIN: the receive buffer of the consumer is full
+    return false;
+}
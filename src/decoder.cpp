@@ -22,26 +22,46 @@
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
+#include <vector>
 
-Decoder::Decoder(unsigned receive_port, const std::string& borzoi_url, const std::string& borzoi_uuid, bool packed,
-                 std::optional<std::string> input_file, std::optional<std::string> output_file, bool iq_or_bit_stream,
+Decoder::Decoder(unsigned receive_port, const std::optional<std::string>& transmit_destination,
+                 std::size_t transmit_queue_capacity, const std::string& borzoi_url, const std::string& borzoi_uuid,
+                 const BorzoiSenderOptions& borzoi_sender_options, bool packed, std::optional<std::string> input_file,
+                 std::optional<std::string> output_file, bool iq_or_bit_stream, IQFormat iq_format,
                  std::optional<unsigned int> uplink_scrambling_code,
                  const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
     : lower_mac_work_queue_(std::make_shared<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>>(
           termination_flag_, upper_mac_termination_flag_, 4))
     , packed_(packed)
     , uplink_scrambling_code_(uplink_scrambling_code)
-    , iq_or_bit_stream_(iq_or_bit_stream) {
+    , iq_or_bit_stream_(iq_or_bit_stream)
+    , iq_format_(iq_format) {
     auto is_uplink = uplink_scrambling_code_.has_value();
     auto lower_mac = std::make_shared<LowerMac>(prometheus_exporter, uplink_scrambling_code);
-    upper_mac_ = std::make_unique<UpperMac>(lower_mac_work_queue_, bozoi_queue_, upper_mac_termination_flag_,
-                                            borzoi_sender_termination_flag_, prometheus_exporter);
-    borzoi_sender_ =
-        std::make_unique<BorzoiSender>(bozoi_queue_, borzoi_sender_termination_flag_, borzoi_url, borzoi_uuid);
-    bit_stream_decoder_ =
-        std::make_shared<BitStreamDecoder>(lower_mac_work_queue_, lower_mac, uplink_scrambling_code_.has_value());
+    upper_mac_ = std::make_unique<UpperMac>(lower_mac_work_queue_, output_queue_, upper_mac_termination_flag_,
+                                            output_fan_out_termination_flag_, prometheus_exporter);
+
+    // every sink has its own queue and thread
+    std::vector<std::shared_ptr<OutputSinkQueue>> sinks;
+    sinks.emplace_back(
+        std::make_shared<OutputSinkQueue>("Borzoi", borzoi_sender_options.queue_capacity, prometheus_exporter));
+    borzoi_sender_ = std::make_unique<BorzoiSender>(sinks.back(), output_sink_termination_flag_, borzoi_url,
+                                                    borzoi_sender_options, prometheus_exporter);
+    if (transmit_destination) {
+        sinks.emplace_back(std::make_shared<OutputSinkQueue>("Datagram", transmit_queue_capacity, prometheus_exporter));
+        datagram_sink_ =
+            std::make_unique<DatagramSink>(*transmit_destination, sinks.back(), output_sink_termination_flag_);
+    }
+    const auto serialize_json_text =
+        transmit_destination.has_value() || borzoi_sender_options.wire_format == BorzoiWireFormat::kJson;
+    output_fan_out_ =
+        std::make_unique<OutputFanOut>(output_queue_, output_fan_out_termination_flag_, output_sink_termination_flag_,
+                                       borzoi_uuid, std::move(sinks), serialize_json_text);
+    bit_stream_decoder_ = std::make_shared<BitStreamDecoder>(lower_mac_work_queue_, lower_mac,
+                                                             uplink_scrambling_code_.has_value(), prometheus_exporter);
     iq_stream_decoder_ =
-        std::make_unique<IQStreamDecoder>(lower_mac_work_queue_, lower_mac, bit_stream_decoder_, is_uplink);
+        std::make_unique<IQStreamDecoder>(lower_mac_work_queue_, lower_mac, bit_stream_decoder_, is_uplink,
+                                          prometheus_exporter);
 
     // read input file from file or from socket
     if (input_file.has_value()) {
@@ -98,6 +118,12 @@ void Decoder::main_loop() {
         throw std::runtime_error("Read error.");
     }
     if (bytes_read == 0) {
+        // the last uplink burst of a finite input is only passed on once the stream ends
+        if (iq_or_bit_stream_) {
+            iq_stream_decoder_->flush();
+        } else {
+            bit_stream_decoder_->flush();
+        }
         stop = true;
         return;
     }
@@ -111,15 +137,14 @@ void Decoder::main_loop() {
     }
 
     if (iq_or_bit_stream_) {
-        const auto* rx_buffer_complex = reinterpret_cast<std::complex<float>*>(rx_buffer.data());
+        const auto sample_size = bytes_per_sample(iq_format_);
 
-        assert((bytes_read % sizeof(*rx_buffer_complex) == 0) &&
-               "Size of rx_buffer is not a multiple of std::complex<float>");
-        const auto size = bytes_read / sizeof(*rx_buffer_complex);
+        assert((bytes_read % sample_size == 0) && "Size of rx_buffer is not a multiple of the IQ sample size");
+        const auto size = bytes_read / sample_size;
 
-        for (auto i = 0; i < size; i++) {
-            iq_stream_decoder_->process_complex(rx_buffer_complex[i]);
-        }
+        convert_iq_samples(iq_format_, rx_buffer.data(), size, iq_samples_.data());
+
+        iq_stream_decoder_->process_complex(iq_samples_.data(), size);
     } else {
         for (auto i = 0; i < bytes_read; i++) {
             if (packed_) {
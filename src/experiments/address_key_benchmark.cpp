@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "utils/address.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+/// The number of lookups that are precomputed and cycled through in each benchmark
+constexpr std::size_t kLookupCount = 1 << 16;
+
+/// The hash of the Address that was used before the AddressKey was introduced
+struct StringAddressHash {
+    auto operator()(const Address& address) const -> std::size_t {
+        auto stream = std::stringstream();
+        stream << address;
+        return std::hash<std::string>()(stream.str());
+    }
+};
+
+/// Create the addresses of the subscribers in a network. SSIs are handed out to fleets in contiguous blocks of 16 to
+/// 512 numbers. Most addresses only contain an SSI, some contain an event label or an usage marker as they are seen
+/// in the MAC headers.
+auto build_subscribers(std::size_t count, std::mt19937& generator) -> std::vector<Address> {
+    std::uniform_int_distribution<uint32_t> fleet_base(0, (1U << 24) - 513);
+    std::uniform_int_distribution<uint32_t> fleet_size(16, 512);
+    std::uniform_int_distribution<unsigned> percentage(0, 99);
+    std::uniform_int_distribution<unsigned> event_label(0, (1U << 10) - 1);
+    std::uniform_int_distribution<unsigned> usage_marker(0, (1U << 6) - 1);
+
+    std::vector<Address> subscribers;
+    while (subscribers.size() < count) {
+        const auto base = fleet_base(generator);
+        const auto size = fleet_size(generator);
+        for (uint32_t ssi = base; ssi < base + size && subscribers.size() < count; ssi++) {
+            Address address;
+            address.set_ssi(ssi);
+            const auto kind = percentage(generator);
+            if (kind < 5) {
+                address.set_event_label(event_label(generator));
+            } else if (kind < 10) {
+                address.set_usage_marker(usage_marker(generator));
+            }
+            subscribers.emplace_back(address);
+        }
+    }
+
+    return subscribers;
+}
+
+/// Create the sequence of looked up addresses. A few subscribers are responsible for most of the traffic, which is
+/// modeled with a zipf distribution. The given percentage of lookups are for addresses that are not in the table.
+auto build_lookups(const std::vector<Address>& subscribers, unsigned miss_percentage, std::mt19937& generator)
+    -> std::vector<Address> {
+    std::vector<double> weights;
+    weights.reserve(subscribers.size());
+    for (std::size_t rank = 1; rank <= subscribers.size(); rank++) {
+        weights.emplace_back(1.0 / std::pow(static_cast<double>(rank), 1.1));
+    }
+    std::discrete_distribution<std::size_t> subscriber(weights.cbegin(), weights.cend());
+    std::uniform_int_distribution<unsigned> percentage(0, 99);
+    std::uniform_int_distribution<uint32_t> random_ssi(0, (1U << 24) - 1);
+
+    std::vector<Address> lookups;
+    lookups.reserve(kLookupCount);
+    for (std::size_t i = 0; i < kLookupCount; i++) {
+        if (percentage(generator) < miss_percentage) {
+            Address address;
+            address.set_ssi(random_ssi(generator));
+            lookups.emplace_back(address);
+        } else {
+            lookups.emplace_back(subscribers[subscriber(generator)]);
+        }
+    }
+
+    return lookups;
+}
+
+/// Run a function the given number of times and print the time taken per iteration
+template <typename Function> auto measure(const char* name, std::size_t iterations, Function&& function) -> void {
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        function(i);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << ": " << static_cast<double>(nanoseconds) / static_cast<double>(iterations) << " ns/lookup"
+              << std::endl;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    std::size_t iterations = 0;
+    std::size_t subscriber_count = 0;
+    unsigned miss_percentage = 0;
+
+    cxxopts::Options options("address-key-benchmark",
+                             "Measures the lookup of state indexed by addresses in ordered and hashed maps.");
+
+    // clang-format off
+	options.add_options()
+		("h,help", "Print usage")
+		("iterations", "the number of lookups in each benchmark", cxxopts::value<std::size_t>(iterations)->default_value("1000000"))
+		("subscribers", "the number of subscribers in the table", cxxopts::value<std::size_t>(subscriber_count)->default_value("5000"))
+		("miss-percentage", "the percentage of lookups for addresses that are not in the table", cxxopts::value<unsigned>(miss_percentage)->default_value("10"))
+		;
+    // clang-format on
+
+    try {
+        auto result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help() << std::endl;
+            return EXIT_SUCCESS;
+        }
+    } catch (std::exception& e) {
+        std::cout << "error parsing options: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::mt19937 generator(42); // NOLINT(cert-msc32-c,cert-msc51-cpp) reproducible benchmark input
+    const auto subscribers = build_subscribers(subscriber_count, generator);
+    const auto lookups = build_lookups(subscribers, miss_percentage, generator);
+
+    std::map<Address, std::size_t> address_map;
+    std::unordered_map<Address, std::size_t, StringAddressHash> address_string_hash_map;
+    std::map<AddressKey, std::size_t> key_map;
+    std::unordered_map<AddressKey, std::size_t> key_hash_map;
+    for (std::size_t i = 0; i < subscribers.size(); i++) {
+        address_map.emplace(subscribers[i], i);
+        address_string_hash_map.emplace(subscribers[i], i);
+        key_map.emplace(subscribers[i].key(), i);
+        key_hash_map.emplace(subscribers[i].key(), i);
+    }
+
+    std::size_t checksum = 0;
+
+    measure("std::map<Address>", iterations, [&](std::size_t i) {
+        auto it = address_map.find(lookups[i % kLookupCount]);
+        checksum += it == address_map.end() ? 1 : it->second;
+    });
+
+    measure("std::unordered_map<Address> with string hash", iterations, [&](std::size_t i) {
+        auto it = address_string_hash_map.find(lookups[i % kLookupCount]);
+        checksum += it == address_string_hash_map.end() ? 1 : it->second;
+    });
+
+    measure("std::map<AddressKey>", iterations, [&](std::size_t i) {
+        auto it = key_map.find(lookups[i % kLookupCount].key());
+        checksum += it == key_map.end() ? 1 : it->second;
+    });
+
+    measure("std::unordered_map<AddressKey>", iterations, [&](std::size_t i) {
+        auto it = key_hash_map.find(lookups[i % kLookupCount].key());
+        checksum += it == key_hash_map.end() ? 1 : it->second;
+    });
+
+    // print the checksum so the compiler cannot optimize the benchmarks away
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "borzoi/borzoi_packets.hpp"
+#include "borzoi/borzoi_wire_format.hpp"
+#include "burst_type.hpp"
+#include "l2/logical_channel.hpp"
+#include "l2/logical_link_control_parser.hpp"
+#include "l2/slot.hpp"
+#include "l2/timebase_counter.hpp"
+#include "l2/upper_mac_packet_builder.hpp"
+#include "nlohmann/borzoi_send_tetra_packet.hpp" // IWYU pragma: keep
+#include "nlohmann/borzoi_send_tetra_slots.hpp"  // IWYU pragma: keep
+#include "utils/bit_vector.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The number of bits in a SCH/F block
+constexpr std::size_t kSignallingChannelFullBits = 268;
+
+/// The UUID of the station that is included in every packet
+constexpr const char* kStationUuid = "00000000-0000-0000-0000-000000000000";
+
+/// Append a value MSB first to a vector of bits
+auto append_bits(std::vector<bool>& bits, uint64_t value, std::size_t number_bits) -> void {
+    for (std::size_t i = number_bits; i > 0; i--) {
+        bits.push_back(((value >> (i - 1)) & 1U) != 0U);
+    }
+}
+
+/// Build the SCH/F block of a MAC-RESOURCE containing a D-SDS-DATA with a LIP short location report. This is the same
+/// packet as in the parser benchmark.
+auto build_mac_resource_with_d_sds_data() -> std::vector<bool> {
+    std::vector<bool> bits;
+
+    // MAC-RESOURCE
+    append_bits(bits, /*pdu_type=*/0b00, 2);
+    append_bits(bits, /*fill_bit_indication=*/0b1, 1);
+    append_bits(bits, /*position_of_grant=*/0b0, 1);
+    append_bits(bits, /*encryption_mode=*/0b00, 2);
+    append_bits(bits, /*random_access_flag=*/0b0, 1);
+    append_bits(bits, /*length_indication=*/0b111110, 6);
+    append_bits(bits, /*address_type=*/0b001, 3);
+    append_bits(bits, /*ssi=*/1234567, 24);
+    append_bits(bits, /*power_control_flag=*/0b0, 1);
+    append_bits(bits, /*slot_granting_flag=*/0b0, 1);
+    append_bits(bits, /*channel_allocation_flag=*/0b0, 1);
+
+    // LLC BL-DATA without FCS
+    append_bits(bits, /*pdu_type=*/0b0001, 4);
+    append_bits(bits, /*n_s=*/0b0, 1);
+
+    // MLE
+    append_bits(bits, /*protocol_discriminator=*/0b010, 3);
+
+    // CMCE D-SDS-DATA
+    append_bits(bits, /*pdu_type=*/15, 5);
+    append_bits(bits, /*calling_party_type_identifier=*/0b01, 2);
+    append_bits(bits, /*calling_party_ssi=*/7654321, 24);
+    append_bits(bits, /*short_data_type_identifier=*/0b11, 2);
+    append_bits(bits, /*length_indicator=*/84, 11);
+
+    // SDS LIP short location report
+    append_bits(bits, /*protocol_identifier=*/0x0A, 8);
+    append_bits(bits, /*pdu_type=*/0b00, 2);
+    append_bits(bits, /*time_elapsed=*/0b01, 2);
+    append_bits(bits, /*longitude=*/0x0987654, 25);
+    append_bits(bits, /*latitude=*/0x123456, 24);
+    append_bits(bits, /*position_error=*/0b010, 3);
+    append_bits(bits, /*horizontal_velocity=*/20, 7);
+    append_bits(bits, /*direction_of_travel=*/0b0100, 4);
+    append_bits(bits, /*type_of_additional_data=*/0b0, 1);
+    append_bits(bits, /*additional_data=*/0x2A, 8);
+
+    // CMCE O-bit: no optional elements
+    append_bits(bits, 0b0, 1);
+
+    // fill bits
+    bits.push_back(true);
+    while (bits.size() < kSignallingChannelFullBits) {
+        bits.push_back(false);
+    }
+
+    return bits;
+}
+
+/// Serialize a packet the given number of times and print the time taken and the size of the packet and of a batch
+template <typename Packet>
+auto measure(const char* name, BorzoiWireFormat format, std::size_t iterations, std::size_t batch_size,
+             const Packet& packet) -> std::size_t {
+    std::size_t checksum = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        nlohmann::json json = packet;
+        checksum += serialize_borzoi_packet(json, format).size();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    nlohmann::json json = packet;
+    const auto payload = serialize_borzoi_packet(json, format);
+    const auto batch = serialize_borzoi_batch(std::vector<std::string>(batch_size, payload), format);
+
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << " " << to_string(format) << ": "
+              << static_cast<double>(nanoseconds) / static_cast<double>(iterations) << " ns/packet, " << payload.size()
+              << " bytes/packet, " << batch.size() << " bytes/batch of " << batch_size << std::endl;
+
+    return checksum;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    std::size_t iterations = 0;
+    std::size_t batch_size = 0;
+
+    cxxopts::Options options("borzoi-wire-format-benchmark",
+                             "Measures the serialization of packets for borzoi in each wire format.");
+
+    // clang-format off
+	options.add_options()
+		("h,help", "Print usage")
+		("iterations", "the number of times each packet is serialized", cxxopts::value<std::size_t>(iterations)->default_value("100000"))
+		("batch-size", "the number of packets in the batch of which the size is printed", cxxopts::value<std::size_t>(batch_size)->default_value("50"))
+		;
+    // clang-format on
+
+    try {
+        auto result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help() << std::endl;
+            return EXIT_SUCCESS;
+        }
+    } catch (std::exception& e) {
+        std::cout << "error parsing options: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto bits = build_mac_resource_with_d_sds_data();
+    const auto logical_channel_data = LogicalChannelDataAndCrc{
+        .channel = LogicalChannel::kSignallingChannelFull, .data = BitVector(bits), .crc_ok = true};
+    const auto slot = ConcreateSlot(BurstType::NormalDownlinkBurst, logical_channel_data);
+
+    LogicalLinkControlParser logical_link_control(/*prometheus_exporter=*/nullptr);
+    const auto packet =
+        logical_link_control.parse(UpperMacPacketBuilder::parse_slot(slot).c_plane_signalling_packets_.front());
+
+    // a full slot that failed the CRC check, as it is sent to the failed slots endpoint
+    const auto failed_slots =
+        Slots(BurstType::NormalDownlinkBurst, TimebaseCounter(1, 1, 1), SlotType::kFullSlot,
+              Slot(LogicalChannelDataAndCrc{
+                  .channel = LogicalChannel::kSignallingChannelFull, .data = BitVector(bits), .crc_ok = false}));
+
+    std::size_t checksum = 0;
+
+    for (auto format : {BorzoiWireFormat::kJson, BorzoiWireFormat::kCbor, BorzoiWireFormat::kMessagePack}) {
+        checksum += measure("D-SDS-DATA", format, iterations, batch_size, BorzoiSendTetraPacket(packet, kStationUuid));
+    }
+
+    for (auto format : {BorzoiWireFormat::kJson, BorzoiWireFormat::kCbor, BorzoiWireFormat::kMessagePack}) {
+        checksum +=
+            measure("failed slots", format, iterations, batch_size, BorzoiSendTetraSlots(failed_slots, kStationUuid));
+    }
+
+    // print the checksum so the compiler cannot optimize the benchmarks away
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,372 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "burst_type.hpp"
+#include "l2/logical_channel.hpp"
+#include "l2/logical_link_control_parser.hpp"
+#include "l2/slot.hpp"
+#include "l2/upper_mac_fragments.hpp"
+#include "l2/upper_mac_packet_builder.hpp"
+#include "l3/circuit_mode_control_entity_packet.hpp"
+#include "l3/short_data_service_packet.hpp"
+#include "utils/bit_vector.hpp"
+#include "utils/ostream_std_unique_ptr_logical_link_control_packet.hpp"
+#include "utils/type234_parser.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <new>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+/// The number of heap allocations counted by the replaced global operator new
+std::atomic<std::size_t> allocation_count{0};
+
+} // namespace
+
+auto operator new(std::size_t size) -> void* {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (auto* ptr = std::malloc(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept { std::free(ptr); }
+
+namespace {
+
+/// The number of bits in a SCH/F block
+constexpr std::size_t kSignallingChannelFullBits = 268;
+
+/// Append a value MSB first to a vector of bits
+auto append_bits(std::vector<bool>& bits, uint64_t value, std::size_t number_bits) -> void {
+    for (std::size_t i = number_bits; i > 0; i--) {
+        bits.push_back(((value >> (i - 1)) & 1U) != 0U);
+    }
+}
+
+/// Build the SCH/F block of a MAC-RESOURCE containing a D-SDS-DATA with a LIP short location report.
+auto build_mac_resource_with_d_sds_data() -> std::vector<bool> {
+    std::vector<bool> bits;
+
+    // MAC-RESOURCE
+    append_bits(bits, /*pdu_type=*/0b00, 2);
+    append_bits(bits, /*fill_bit_indication=*/0b1, 1);
+    append_bits(bits, /*position_of_grant=*/0b0, 1);
+    append_bits(bits, /*encryption_mode=*/0b00, 2);
+    append_bits(bits, /*random_access_flag=*/0b0, 1);
+    append_bits(bits, /*length_indication=*/0b111110, 6);
+    append_bits(bits, /*address_type=*/0b001, 3);
+    append_bits(bits, /*ssi=*/1234567, 24);
+    append_bits(bits, /*power_control_flag=*/0b0, 1);
+    append_bits(bits, /*slot_granting_flag=*/0b0, 1);
+    append_bits(bits, /*channel_allocation_flag=*/0b0, 1);
+
+    // LLC BL-DATA without FCS
+    append_bits(bits, /*pdu_type=*/0b0001, 4);
+    append_bits(bits, /*n_s=*/0b0, 1);
+
+    // MLE
+    append_bits(bits, /*protocol_discriminator=*/0b010, 3);
+
+    // CMCE D-SDS-DATA
+    append_bits(bits, /*pdu_type=*/15, 5);
+    append_bits(bits, /*calling_party_type_identifier=*/0b01, 2);
+    append_bits(bits, /*calling_party_ssi=*/7654321, 24);
+    append_bits(bits, /*short_data_type_identifier=*/0b11, 2);
+    append_bits(bits, /*length_indicator=*/84, 11);
+
+    // SDS LIP short location report
+    append_bits(bits, /*protocol_identifier=*/0x0A, 8);
+    append_bits(bits, /*pdu_type=*/0b00, 2);
+    append_bits(bits, /*time_elapsed=*/0b01, 2);
+    append_bits(bits, /*longitude=*/0x0987654, 25);
+    append_bits(bits, /*latitude=*/0x123456, 24);
+    append_bits(bits, /*position_error=*/0b010, 3);
+    append_bits(bits, /*horizontal_velocity=*/20, 7);
+    append_bits(bits, /*direction_of_travel=*/0b0100, 4);
+    append_bits(bits, /*type_of_additional_data=*/0b0, 1);
+    append_bits(bits, /*additional_data=*/0x2A, 8);
+
+    // CMCE O-bit: no optional elements
+    append_bits(bits, 0b0, 1);
+
+    // fill bits
+    bits.push_back(true);
+    while (bits.size() < kSignallingChannelFullBits) {
+        bits.push_back(false);
+    }
+
+    return bits;
+}
+
+/// Build the optional elements of a D-SDS-DATA: the O-bit followed by an external subscriber number and a DM-MS address
+/// as type 3 elements.
+auto build_sds_data_type3_elements() -> std::vector<bool> {
+    std::vector<bool> bits;
+
+    append_bits(bits, /*o_bit=*/0b1, 1);
+    for (auto element_identifier : {CircuitModeControlEntityType3ElementIdentifiers::kExternalSubsriberNumber,
+                                    CircuitModeControlEntityType3ElementIdentifiers::kDmMsAddress}) {
+        append_bits(bits, /*m_bit=*/0b1, 1);
+        append_bits(bits, static_cast<uint64_t>(element_identifier), 4);
+        append_bits(bits, /*length_indicator=*/24, 11);
+        append_bits(bits, /*element=*/0x123456, 24);
+    }
+    append_bits(bits, /*m_bit=*/0b0, 1);
+
+    return bits;
+}
+
+/// Build a corpus of SCH/F slots that passed the CRC check. The given percentage of slots contains random bits, which
+/// are mostly malformed or truncated PDUs, the rest is the valid MAC-RESOURCE.
+auto build_corpus(const std::vector<bool>& valid_bits, unsigned malformed_percentage) -> std::vector<ConcreateSlot> {
+    constexpr std::size_t kCorpusSize = 1000;
+
+    std::mt19937 generator(/*seed=*/42);
+    std::bernoulli_distribution random_bit;
+    std::uniform_int_distribution<unsigned> percentage(0, 99);
+
+    std::vector<ConcreateSlot> corpus;
+    for (std::size_t i = 0; i < kCorpusSize; i++) {
+        auto bits = valid_bits;
+        if (percentage(generator) < malformed_percentage) {
+            for (auto&& bit : bits) {
+                bit = random_bit(generator);
+            }
+        }
+        const auto logical_channel_data = LogicalChannelDataAndCrc{
+            .channel = LogicalChannel::kSignallingChannelFull, .data = BitVector(bits), .crc_ok = true};
+        corpus.emplace_back(BurstType::NormalDownlinkBurst, logical_channel_data);
+    }
+
+    return corpus;
+}
+
+/// Run a function the given number of times and print the time taken and the heap allocations per iteration
+template <typename Function> auto measure(const char* name, std::size_t iterations, Function&& function) -> void {
+    const auto allocations_before = allocation_count.load();
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; i++) {
+        function();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    const auto allocations = allocation_count.load() - allocations_before;
+
+    const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << ": " << static_cast<double>(nanoseconds) / static_cast<double>(iterations) << " ns/iteration, "
+              << static_cast<double>(allocations) / static_cast<double>(iterations) << " allocations/iteration"
+              << std::endl;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    std::size_t iterations = 0;
+    unsigned malformed_percentage = 0;
+
+    cxxopts::Options options("parser-benchmark",
+                             "Measures the time it takes to parse a MAC-RESOURCE containing a D-SDS-DATA.");
+
+    // clang-format off
+	options.add_options()
+		("h,help", "Print usage")
+		("iterations", "the number of times each benchmark is run", cxxopts::value<std::size_t>(iterations)->default_value("100000"))
+		("malformed-percentage", "the percentage of malformed slots in the corpus of the error path benchmarks", cxxopts::value<unsigned>(malformed_percentage)->default_value("90"))
+		;
+    // clang-format on
+
+    try {
+        auto result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help() << std::endl;
+            return EXIT_SUCCESS;
+        }
+    } catch (std::exception& e) {
+        std::cout << "error parsing options: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const auto bits = build_mac_resource_with_d_sds_data();
+    const auto logical_channel_data = LogicalChannelDataAndCrc{
+        .channel = LogicalChannel::kSignallingChannelFull, .data = BitVector(bits), .crc_ok = true};
+    const auto slot = ConcreateSlot(BurstType::NormalDownlinkBurst, logical_channel_data);
+
+    LogicalLinkControlParser logical_link_control(/*prometheus_exporter=*/nullptr);
+
+    // make sure the parse chain actually reaches the SDS parser
+    {
+        auto packets = UpperMacPacketBuilder::parse_slot(slot);
+        if (packets.c_plane_signalling_packets_.size() != 1) {
+            std::cout << "Expected exactly one c-plane signalling packet." << std::endl;
+            return EXIT_FAILURE;
+        }
+        auto packet = logical_link_control.parse(packets.c_plane_signalling_packets_.front());
+        if (dynamic_cast<ShortDataServicePacket*>(packet.get()) == nullptr) {
+            std::cout << "Expected the packet to be parsed into a ShortDataServicePacket." << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::cout << packet << std::endl;
+    }
+
+    std::size_t checksum = 0;
+
+    // the lower MAC creates the BitVectors of the AACH and the SCH/F for each normal downlink burst
+    std::array<bool, kSignallingChannelFullBits> burst_bits{};
+    std::copy(bits.cbegin(), bits.cend(), burst_bits.begin());
+
+    measure("burst BitVectors", iterations, [&]() {
+        auto aach = BitVector(burst_bits.cbegin(), burst_bits.cbegin() + 14);
+        auto sch_f = BitVector(burst_bits.cbegin(), burst_bits.cend());
+        checksum += aach.bits_left() + sch_f.bits_left();
+    });
+
+    measure("BitVector take", iterations, [&]() {
+        auto data = BitVector(logical_channel_data.data);
+        while (data.bits_left() >= 24) {
+            checksum += static_cast<std::size_t>(data.take<24>());
+            checksum += static_cast<std::size_t>(data.take<3>());
+            checksum += static_cast<std::size_t>(data.take<1>());
+        }
+    });
+
+    measure("MAC-RESOURCE", iterations, [&]() {
+        auto packets = UpperMacPacketBuilder::parse_slot(slot);
+        checksum += packets.c_plane_signalling_packets_.size();
+    });
+
+    const auto c_plane_packet = UpperMacPacketBuilder::parse_slot(slot).c_plane_signalling_packets_.front();
+
+    measure("LLC + MLE + CMCE + SDS", iterations, [&]() {
+        auto llc = logical_link_control.parse(UpperMacCPlaneSignallingPacket(c_plane_packet));
+        checksum += llc->tl_sdu_.bits_left();
+    });
+
+    // the optional elements of CMCE and MM packets are stored without a heap allocation
+    const auto type3_element_bits = BitVector(build_sds_data_type3_elements());
+
+    measure("CMCE type 3 elements", iterations, [&]() {
+        using ElementIdentifier = CircuitModeControlEntityType3ElementIdentifiers;
+        auto data = BitVector(type3_element_bits);
+        auto parser = Type234Parser<ElementIdentifier>(
+            data, {ElementIdentifier::kExternalSubsriberNumber, ElementIdentifier::kDmMsAddress}, {});
+        const auto elements = parser.parse_type34(data);
+        checksum += elements.at(ElementIdentifier::kDmMsAddress).unparsed_bits.bits_left();
+    });
+
+    measure("MAC-RESOURCE + D-SDS-DATA", iterations, [&]() {
+        auto packets = UpperMacPacketBuilder::parse_slot(slot);
+        for (auto& packet : packets.c_plane_signalling_packets_) {
+            if (packet.tm_sdu_) {
+                auto llc = logical_link_control.parse(std::move(packet));
+                checksum += llc->tl_sdu_.bits_left();
+            }
+        }
+    });
+
+    // compare the exception and the parse result error path on a corpus with many malformed slots
+    const auto corpus = build_corpus(bits, malformed_percentage);
+
+    // the fragment reassembly and the parsers above the upper MAC still throw on malformed PDUs. they only get the
+    // packets of the slots that passed the upper MAC.
+    auto downlink_fragmentation = UpperMacDownlinkFragmentation(/*metrics=*/nullptr);
+    const auto parse_upper_layers = [&](UpperMacPackets& packets) -> std::size_t {
+        std::size_t exceptions = 0;
+        for (auto& packet : packets.c_plane_signalling_packets_) {
+            try {
+                std::optional<UpperMacCPlaneSignallingPacket> complete_packet;
+                if (packet.is_downlink_fragment()) {
+                    complete_packet = downlink_fragmentation.push_fragment(packet);
+                } else if (packet.tm_sdu_) {
+                    complete_packet = std::move(packet);
+                }
+                if (complete_packet) {
+                    auto llc = logical_link_control.parse(std::move(*complete_packet));
+                    checksum += llc->tl_sdu_.bits_left();
+                }
+            } catch (std::runtime_error& e) {
+                exceptions++;
+            }
+        }
+        return exceptions;
+    };
+
+    {
+        std::array<std::size_t, kParseErrorCategoryCount> errors{};
+        std::size_t passed_slots = 0;
+        std::size_t upper_layer_exceptions = 0;
+        for (const auto& corpus_slot : corpus) {
+            auto packets = UpperMacPacketBuilder::try_parse_slot(corpus_slot);
+            if (!packets) {
+                errors.at(static_cast<std::size_t>(packets.error().category))++;
+                continue;
+            }
+            passed_slots++;
+            upper_layer_exceptions += parse_upper_layers(*packets);
+        }
+        std::cout << "parse errors in the corpus of " << corpus.size() << " slots:";
+        for (std::size_t category = 0; category < kParseErrorCategoryCount; category++) {
+            std::cout << " " << to_string(ParseErrorCategory(category)) << "=" << errors.at(category);
+        }
+        std::cout << std::endl;
+        std::cout << "exceptions above the upper MAC for the " << passed_slots
+                  << " slots that passed it: " << upper_layer_exceptions << std::endl;
+    }
+
+    std::size_t corpus_index = 0;
+    measure("malformed corpus with exceptions", iterations, [&]() {
+        const auto& corpus_slot = corpus[corpus_index++ % corpus.size()];
+        try {
+            auto packets = UpperMacPacketBuilder::parse_slot(corpus_slot);
+            checksum += packets.c_plane_signalling_packets_.size();
+        } catch (std::runtime_error& e) {
+            checksum++;
+        }
+    });
+
+    corpus_index = 0;
+    measure("malformed corpus with parse results", iterations, [&]() {
+        const auto& corpus_slot = corpus[corpus_index++ % corpus.size()];
+        auto packets = UpperMacPacketBuilder::try_parse_slot(corpus_slot);
+        if (packets) {
+            checksum += packets->c_plane_signalling_packets_.size();
+        } else {
+            checksum++;
+        }
+    });
+
+    corpus_index = 0;
+    measure("malformed corpus through all layers", iterations, [&]() {
+        const auto& corpus_slot = corpus[corpus_index++ % corpus.size()];
+        auto packets = UpperMacPacketBuilder::try_parse_slot(corpus_slot);
+        if (packets) {
+            checksum += parse_upper_layers(*packets);
+        } else {
+            checksum++;
+        }
+    });
+
+    // print the checksum so the compiler cannot optimize the benchmarks away
+    std::cout << "checksum: " << checksum << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "iq_stream_decoder.hpp"
+#include <complex>
+#include <cstddef>
+#include <cstdlib>
+#include <cxxopts.hpp>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// The maximum deviation of the equalizer taps from a unit center tap for a burst without distortion
+constexpr float kMaxTapError = 0.1F;
+
+/// The number of symbols in IQStreamDecoder::QueueT
+constexpr std::size_t kSymbolBufferLength = 300;
+
+/// The number of random symbols before and after the synthetic burst
+constexpr std::size_t kGuardSymbols = 300;
+
+/// An uplink burst as it is detected and trained by the IQStreamDecoder
+struct BurstLayout {
+    std::string name;
+    std::size_t length;
+    std::size_t training_seq_offset;
+    const std::vector<std::complex<float>>& training_seq;
+};
+
+auto random_symbol(std::mt19937& generator) -> std::complex<float> {
+    std::uniform_int_distribution<int> sign(0, 1);
+    return {sign(generator) != 0 ? 1.0F : -1.0F, sign(generator) != 0 ? 1.0F : -1.0F};
+}
+
+/// Create a stream of random symbols that contains a single burst with the training sequence at its offset
+auto synthetic_stream(const BurstLayout& layout, const float noise, std::mt19937& generator)
+    -> std::vector<std::complex<float>> {
+    std::normal_distribution<float> noise_distribution(0, noise);
+
+    std::vector<std::complex<float>> stream;
+    for (std::size_t i = 0; i < kGuardSymbols + layout.length + kGuardSymbols; i++) {
+        stream.emplace_back(random_symbol(generator));
+    }
+    for (std::size_t i = 0; i < layout.training_seq.size(); i++) {
+        stream[kGuardSymbols + layout.training_seq_offset + i] = layout.training_seq[i];
+    }
+    for (auto& symbol : stream) {
+        symbol += std::complex<float>(noise_distribution(generator), noise_distribution(generator));
+    }
+
+    return stream;
+}
+
+/// Run the stream through the burst detection of the IQStreamDecoder, train the equalizer on the best detection and
+/// check that the detection is aligned with the burst and the taps are close to a unit center tap.
+auto check_burst(const BurstLayout& layout, const float noise, std::mt19937& generator) -> bool {
+    const auto stream = synthetic_stream(layout, noise, generator);
+
+    IQStreamDecoder::QueueT symbol_buffer;
+    IQStreamDecoder::QueueT symbol_buffer_hard_decision;
+
+    float best_correlation = -1;
+    std::size_t best_start = 0;
+    std::vector<std::complex<float>> best_burst;
+
+    for (std::size_t i = 0; i < stream.size(); i++) {
+        const auto& symbol = stream[i];
+        symbol_buffer.push(symbol);
+        symbol_buffer_hard_decision.push({symbol.real() > 0 ? 1.0F : -1.0F, symbol.imag() > 0 ? 1.0F : -1.0F});
+
+        if (i + 1 < kSymbolBufferLength) {
+            continue;
+        }
+
+        const auto correlation = IQStreamDecoder::training_seq_correlation(
+            symbol_buffer_hard_decision, layout.training_seq_offset, layout.training_seq);
+        if (correlation > best_correlation) {
+            best_correlation = correlation;
+            // the burst starts at the beginning of the symbol buffer
+            best_start = i + 1 - kSymbolBufferLength;
+            best_burst.assign(symbol_buffer.cbegin(), symbol_buffer.cbegin() + layout.length);
+        }
+    }
+
+    const auto taps = IQStreamDecoder::channel_estimation(best_burst, layout.training_seq, layout.training_seq_offset);
+
+    constexpr std::size_t kCenterTap = IQStreamDecoder::kEqualizerTaps / 2;
+    auto passed = best_start == kGuardSymbols;
+    for (std::size_t j = 0; j < IQStreamDecoder::kEqualizerTaps; j++) {
+        const auto expected = std::complex<float>(j == kCenterTap ? 1.0F : 0.0F, 0.0F);
+        passed &= std::abs(taps[j] - expected) < kMaxTapError;
+    }
+
+    if (!passed) {
+        std::cout << layout.name << ": burst detected at " << best_start << " (expected " << kGuardSymbols
+                  << "), taps " << taps[0] << " " << taps[1] << " " << taps[2] << std::endl;
+    }
+
+    return passed;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    cxxopts::Options options("uplink-equalizer-check",
+                             "Check the uplink burst detection and equalizer training on synthetic bursts");
+
+    // clang-format off
+	options.add_options()
+		("h,help", "Print usage")
+		("bursts", "<number of synthetic bursts per burst type>", cxxopts::value<std::size_t>()->default_value("100"))
+		("noise", "<standard deviation of the noise per component>", cxxopts::value<float>()->default_value("0.05"))
+		("seed", "<seed of the random number generator>", cxxopts::value<unsigned>()->default_value("0"))
+		;
+    // clang-format on
+
+    std::size_t bursts = 0;
+    float noise = 0;
+    unsigned seed = 0;
+
+    try {
+        auto result = options.parse(argc, argv);
+
+        if (result.count("help")) {
+            std::cout << options.help() << std::endl;
+            return EXIT_SUCCESS;
+        }
+
+        bursts = result["bursts"].as<std::size_t>();
+        noise = result["noise"].as<float>();
+        seed = result["seed"].as<unsigned>();
+    } catch (std::exception& e) {
+        std::cout << "error parsing options: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::vector<BurstLayout> layouts = {
+        BurstLayout{.name = "Control uplink burst",
+                    .length = IQStreamDecoder::kControlUplinkBurstLength,
+                    .training_seq_offset = IQStreamDecoder::kControlUplinkBurstTrainingSeqOffset,
+                    .training_seq = IQStreamDecoder::kExtendedTrainingSequence},
+        BurstLayout{.name = "Normal uplink burst",
+                    .length = IQStreamDecoder::kNormalUplinkBurstLength,
+                    .training_seq_offset = IQStreamDecoder::kNormalUplinkBurstTrainingSeqOffset,
+                    .training_seq = IQStreamDecoder::kNormalTrainingSequence1},
+        BurstLayout{.name = "Normal uplink burst split",
+                    .length = IQStreamDecoder::kNormalUplinkBurstLength,
+                    .training_seq_offset = IQStreamDecoder::kNormalUplinkBurstTrainingSeqOffset,
+                    .training_seq = IQStreamDecoder::kNormalTrainingSequence2},
+    };
+
+    std::mt19937 generator(seed);
+    std::size_t failed = 0;
+    for (const auto& layout : layouts) {
+        for (std::size_t i = 0; i < bursts; i++) {
+            if (!check_burst(layout, noise, generator)) {
+                failed++;
+            }
+        }
+    }
+
+    std::cout << failed << " of " << bursts * layouts.size() << " bursts failed" << std::endl;
+
+    return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "l2/upper_mac_fragments.hpp"
+#include "l2/upper_mac_packet.hpp"
+#include "utils/bit_vector.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Create an uplink fragment of a mobile station
+/// \param type the mac packet type of the fragment
+/// \param ssi the ssi of the mobile station
+/// \param payload a bit that identifies the fragment in the reassembled packet
+auto fragment(const MacPacketType type, const uint32_t ssi, const bool payload) -> UpperMacCPlaneSignallingPacket {
+    UpperMacCPlaneSignallingPacket packet;
+    packet.type_ = type;
+    packet.fragmentation_ = type == MacPacketType::kMacAccess;
+    packet.address_.set_ssi(ssi);
+    packet.tm_sdu_ = BitVector(std::vector<bool>{payload});
+    return packet;
+}
+
+/// Print the result of a check and return if it passed
+auto check(const std::string& name, const bool passed) -> bool {
+    std::cout << name << (passed ? " ok" : " FAILED") << std::endl;
+    return passed;
+}
+
+/// A reassembly is kept while fragments are received within the maximum age and is evicted if the maximum age of
+/// bursts passed without a fragment
+auto check_timeout() -> bool {
+    constexpr std::size_t kMaxAgeBursts = 8;
+    UpperMacUplinkFragmentation fragmentation(/*metrics=*/nullptr, kMaxAgeBursts);
+
+    fragmentation.next_burst();
+    fragmentation.push_fragment(fragment(MacPacketType::kMacAccess, /*ssi=*/1, /*payload=*/true));
+
+    // a continuation within the maximum age keeps the reassembly alive
+    for (std::size_t i = 0; i < kMaxAgeBursts; i++) {
+        fragmentation.next_burst();
+    }
+    fragmentation.push_fragment(fragment(MacPacketType::kMacFragmentUplink, /*ssi=*/1, /*payload=*/false));
+    auto passed = check("reassembly is kept for the maximum age", fragmentation.size() == 1);
+
+    for (std::size_t i = 0; i < kMaxAgeBursts; i++) {
+        fragmentation.next_burst();
+    }
+    passed &= check("reassembly is kept until the maximum age is exceeded", fragmentation.size() == 1);
+
+    fragmentation.next_burst();
+    passed &= check("stale reassembly is evicted after the maximum age", fragmentation.size() == 0);
+
+    // the end fragment of the evicted reassembly does not complete a packet
+    const auto packet = fragmentation.push_fragment(fragment(MacPacketType::kMacEndUplink, /*ssi=*/1, true));
+    passed &= check("end fragment of an evicted reassembly is dropped", !packet && fragmentation.size() == 0);
+
+    return passed;
+}
+
+/// The reassembly that received its last fragment the longest time ago is evicted when the store is full
+auto check_capacity() -> bool {
+    constexpr std::size_t kMaxEntries = 3;
+    UpperMacUplinkFragmentation fragmentation(/*metrics=*/nullptr, UpperMacUplinkFragmentation::kDefaultMaxAgeBursts,
+                                              kMaxEntries);
+
+    for (uint32_t ssi = 1; ssi <= kMaxEntries; ssi++) {
+        fragmentation.next_burst();
+        fragmentation.push_fragment(fragment(MacPacketType::kMacAccess, ssi, /*payload=*/true));
+    }
+
+    // the first reassembly received a fragment last, the second one is now the oldest
+    fragmentation.next_burst();
+    fragmentation.push_fragment(fragment(MacPacketType::kMacFragmentUplink, /*ssi=*/1, /*payload=*/false));
+
+    fragmentation.next_burst();
+    fragmentation.push_fragment(fragment(MacPacketType::kMacAccess, /*ssi=*/4, /*payload=*/true));
+    auto passed = check("store is bounded", fragmentation.size() == kMaxEntries);
+
+    const auto evicted = fragmentation.push_fragment(fragment(MacPacketType::kMacEndUplink, /*ssi=*/2, true));
+    passed &= check("oldest reassembly is evicted", !evicted);
+
+    const auto kept = fragmentation.push_fragment(fragment(MacPacketType::kMacEndUplink, /*ssi=*/1, true));
+    passed &= check("recently used reassembly is kept", kept && kept->tm_sdu_->bits_left() == 3);
+
+    return passed;
+}
+
+} // namespace
+
+auto main(int /*argc*/, char** /*argv*/) -> int {
+    auto passed = check_timeout();
+    passed &= check_capacity();
+
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
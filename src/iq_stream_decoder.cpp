@@ -9,22 +9,30 @@
 
 #include "iq_stream_decoder.hpp"
 #include "l2/lower_mac.hpp"
+#include "utils/complex_simd.hpp"
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <numeric>
+
+namespace {
+constexpr float kTwoPi = 2 * static_cast<float>(M_PI);
+} // namespace
 
 IQStreamDecoder::IQStreamDecoder(
     const std::shared_ptr<StreamingOrderedOutputThreadPoolExecutor<LowerMac::return_type>>& lower_mac_worker_queue,
     const std::shared_ptr<LowerMac>& lower_mac, const std::shared_ptr<BitStreamDecoder>& bit_stream_decoder,
-    bool is_uplink)
-    : lower_mac_(lower_mac)
+    bool is_uplink, const std::shared_ptr<PrometheusExporter>& prometheus_exporter)
+    : uplink_burst_peak_picker_(
+          kUplinkBurstPeakWindow, [this](UplinkBurst&& burst) { process_uplink_burst(std::move(burst)); },
+          prometheus_exporter)
+    , lower_mac_(lower_mac)
     , bit_stream_decoder_(bit_stream_decoder)
     , is_uplink_(is_uplink)
     , lower_mac_worker_queue_(lower_mac_worker_queue) {
-    std::transform(training_seq_n_.crbegin(), training_seq_n_.crend(),
-                   std::back_inserter(training_seq_n_reversed_conj_), [](auto v) { return std::conj(v); });
-    std::transform(training_seq_p_.crbegin(), training_seq_p_.crend(),
-                   std::back_inserter(training_seq_p_reversed_conj_), [](auto v) { return std::conj(v); });
-    std::transform(training_seq_x_.crbegin(), training_seq_x_.crend(),
-                   std::back_inserter(training_seq_x_reversed_conj_), [](auto v) { return std::conj(v); });
+    if (prometheus_exporter) {
+        metrics_ = std::make_unique<IQStreamDecoderMetrics>(prometheus_exporter);
+    }
 }
 
 std::complex<float> IQStreamDecoder::hard_decision(std::complex<float> const& symbol) {
@@ -78,87 +86,224 @@ void IQStreamDecoder::symbols_to_bitstream(iterator_type it, uint8_t* const bits
     }
 }
 
-void IQStreamDecoder::abs_convolve_same_length(const QueueT& queueA, const std::size_t offsetA,
-                                               const std::complex<float>* const itb, const std::size_t len,
-                                               float* res) {
+auto IQStreamDecoder::training_seq_correlation(const QueueT& symbols, const std::size_t training_seq_offset,
+                                               const std::vector<std::complex<float>>& training_seq) -> float {
     std::complex<float> acc = {0.0, 0.0};
-    for (std::size_t i = 0; i < len; ++i) {
-        acc += queueA[offsetA + i] * itb[i];
+    for (std::size_t i = 0; i < training_seq.size(); ++i) {
+        acc += symbols[training_seq_offset + i] * std::conj(training_seq[i]);
     }
-    *res = std::abs(acc);
+    return std::abs(acc);
 }
 
-std::vector<std::complex<float>> IQStreamDecoder::channel_estimation(std::vector<std::complex<float>> const& stream,
-                                                                     std::vector<std::complex<float>> const& pilots) {
-    // TODO: implement channel estimation
-    return stream;
-}
+auto IQStreamDecoder::channel_estimation(const std::vector<std::complex<float>>& burst,
+                                         const std::vector<std::complex<float>>& training_seq,
+                                         const std::size_t training_seq_offset) -> EqualizerTaps {
+    constexpr std::size_t kCenterTap = kEqualizerTaps / 2;
 
-void IQStreamDecoder::process_complex(std::complex<float> symbol) noexcept {
-    if (is_uplink_) {
-        float detectedN;
-        float detectedP;
-        float detectedX;
+    // Build the normal equations A * w = b of the least-squares problem min sum_k |u_k^T * w - t_k|^2, where u_k are
+    // the received symbols around the k-th training symbol t_k.
+    std::array<EqualizerTaps, kEqualizerTaps> a{};
+    EqualizerTaps b{};
 
-        // Control Uplink Burst or Normal Uplink Burst
-        symbol_buffer_.push(symbol);
-        symbol_buffer_hard_decision_.push(hard_decision(symbol));
+    for (std::size_t k = 0; k < training_seq.size(); k++) {
+        EqualizerTaps u{};
+        for (std::size_t j = 0; j < kEqualizerTaps; j++) {
+            const auto position = training_seq_offset + k + j;
+            if (position >= kCenterTap && position - kCenterTap < burst.size()) {
+                u[j] = burst[position - kCenterTap];
+            }
+        }
 
-        // convolve hard_decision with flipped conjugate of n, p and x and check if abs > SEQUENCE_DETECTION_THRESHOLD
-        // to find potential correlation peaks
-        //
-        // find NUB
-        // 2 tail + 108 coded symbols + middle of 11 training sequence (6) = 116
-        abs_convolve_same_length(symbol_buffer_hard_decision_, 109, training_seq_n_reversed_conj_.data(),
-                                 training_seq_n_reversed_conj_.size(), &detectedN);
-        // find NUB_Split
-        // 2 tail + 108 coded symbols + middle of 11 training sequence (6) = 116
-        abs_convolve_same_length(symbol_buffer_hard_decision_, 109, training_seq_p_reversed_conj_.data(),
-                                 training_seq_p_reversed_conj_.size(), &detectedP);
-        // find CUB
-        // 2 tail + 42 coded symbols + middle of 15 training sequence (8) = 52
-        abs_convolve_same_length(symbol_buffer_hard_decision_, 44, training_seq_x_reversed_conj_.data(),
-                                 training_seq_x_reversed_conj_.size(), &detectedX);
+        for (std::size_t i = 0; i < kEqualizerTaps; i++) {
+            const auto u_conj = std::conj(u[i]);
+            b[i] += u_conj * training_seq[k];
+            for (std::size_t j = 0; j < kEqualizerTaps; j++) {
+                a[i][j] += u_conj * u[j];
+            }
+        }
+    }
 
-        if (detectedX >= SEQUENCE_DETECTION_THRESHOLD) {
-            // std::cout << "Potential CUB found" << std::endl;
+    float trace = 0;
+    for (std::size_t i = 0; i < kEqualizerTaps; i++) {
+        trace += a[i][i].real();
+    }
 
-            auto len = 103;
+    EqualizerTaps taps{};
 
-            std::vector<uint8_t> bits(len * 2);
+    // no energy in the training sequence, pass the burst through unchanged
+    if (!(trace > 0)) {
+        taps[kCenterTap] = 1;
+        return taps;
+    }
 
-            symbols_to_bitstream(symbol_buffer_.cbegin(), bits.data(), len);
+    const auto loading = kEqualizerDiagonalLoading * trace / static_cast<float>(kEqualizerTaps);
+    for (std::size_t i = 0; i < kEqualizerTaps; i++) {
+        a[i][i] += loading;
+    }
 
-            auto lower_mac_process_cub = std::bind(&LowerMac::process, lower_mac_, bits, BurstType::ControlUplinkBurst);
-            lower_mac_worker_queue_->queue_work(lower_mac_process_cub);
+    // A is hermitian positive definite, solve it with gaussian elimination without pivoting
+    for (std::size_t col = 0; col < kEqualizerTaps; col++) {
+        for (std::size_t row = col + 1; row < kEqualizerTaps; row++) {
+            const auto factor = a[row][col] / a[col][col];
+            for (std::size_t j = col; j < kEqualizerTaps; j++) {
+                a[row][j] -= factor * a[col][j];
+            }
+            b[row] -= factor * b[col];
         }
+    }
 
-        if (detectedP >= SEQUENCE_DETECTION_THRESHOLD) {
-            // std::cout << "Potential NUB_Split found" << std::endl;
+    for (std::size_t row = kEqualizerTaps; row-- > 0;) {
+        auto value = b[row];
+        for (std::size_t j = row + 1; j < kEqualizerTaps; j++) {
+            value -= a[row][j] * taps[j];
+        }
+        taps[row] = value / a[row][row];
+    }
 
-            auto len = 231;
+    return taps;
+}
 
-            std::vector<uint8_t> bits(len * 2);
+auto IQStreamDecoder::equalize(const std::vector<std::complex<float>>& burst, const EqualizerTaps& taps)
+    -> std::vector<std::complex<float>> {
+    constexpr std::size_t kCenterTap = kEqualizerTaps / 2;
 
-            symbols_to_bitstream(symbol_buffer_.cbegin(), bits.data(), len);
+    // zero pad the burst so that every tap can be applied to the whole burst
+    std::vector<std::complex<float>> padded(burst.size() + kEqualizerTaps - 1);
+    std::copy(burst.cbegin(), burst.cend(), padded.begin() + kCenterTap);
 
-            auto lower_mac_process_nubs =
-                std::bind(&LowerMac::process, lower_mac_, bits, BurstType::NormalUplinkBurstSplit);
-            lower_mac_worker_queue_->queue_work(lower_mac_process_nubs);
-        }
+    std::vector<std::complex<float>> equalized(burst.size());
+    for (std::size_t j = 0; j < kEqualizerTaps; j++) {
+        complex_multiply_accumulate(padded.data() + j, taps[j], equalized.data(), burst.size());
+    }
 
-        if (detectedN >= SEQUENCE_DETECTION_THRESHOLD) {
-            // std::cout << "Potential NUB found" << std::endl;
+    return equalized;
+}
+
+auto IQStreamDecoder::estimate_phase_offset(const std::vector<std::complex<float>>& burst,
+                                            const std::vector<std::complex<float>>& training_seq,
+                                            const std::size_t training_seq_offset) noexcept -> float {
+    std::complex<float> acc = {0.0, 0.0};
+    for (std::size_t k = 0; k < training_seq.size(); k++) {
+        acc += burst[training_seq_offset + k] * std::conj(training_seq[k]);
+    }
+    return std::arg(acc);
+}
 
-            auto len = 231;
+auto IQStreamDecoder::estimate_phase_offset_blind(const std::complex<float>* symbols, const std::size_t count)
+    -> float {
+    fourth_power_symbols_.resize(count);
+    complex_multiply(symbols, symbols, fourth_power_symbols_.data(), count);
+    complex_multiply(fourth_power_symbols_.data(), fourth_power_symbols_.data(), fourth_power_symbols_.data(), count);
 
-            std::vector<uint8_t> bits(len * 2);
+    const auto acc = std::accumulate(fourth_power_symbols_.cbegin(), fourth_power_symbols_.cend(),
+                                     std::complex<float>{0.0, 0.0});
+    // the fourth power of the symbols without phase offset ((+-1, +-1) * 1/sqrt(2)) is -1
+    return std::arg(-acc) / 4;
+}
 
-            symbols_to_bitstream(symbol_buffer_.cbegin(), bits.data(), len);
+void IQStreamDecoder::update_phase_offset(const float residual_phase_offset) noexcept {
+    phase_offset_ = std::remainder(phase_offset_ + kPhaseOffsetLoopGain * residual_phase_offset, kTwoPi);
 
-            auto lower_mac_process_nub = std::bind(&LowerMac::process, lower_mac_, bits, BurstType::NormalUplinkBurst);
-            lower_mac_worker_queue_->queue_work(lower_mac_process_nub);
-        }
+    if (metrics_) {
+        const auto radians_to_hz = kSymbolRate / kTwoPi;
+        metrics_->set_frequency_offset(/*tracked=*/phase_offset_ * radians_to_hz,
+                                       /*residual=*/residual_phase_offset * radians_to_hz);
+    }
+}
+
+void IQStreamDecoder::detect_uplink_burst(const BurstType burst_type, const std::size_t len, const float correlation,
+                                          const std::size_t training_seq_length) {
+    // every product of hard decisions has an absolute value of two
+    const auto quality = correlation / (2.0F * static_cast<float>(training_seq_length));
+
+    if (quality < kUplinkBurstDetectionThreshold) {
+        return;
+    }
+
+    std::vector<std::complex<float>> symbols(symbol_buffer_.cbegin(), symbol_buffer_.cbegin() + len);
+
+    uplink_burst_peak_picker_.detect(uplink_symbol_position_, quality,
+                                     UplinkBurst{.burst_type = burst_type, .symbols = std::move(symbols)});
+}
+
+void IQStreamDecoder::process_uplink_burst(UplinkBurst&& burst) {
+    const auto* training_seq = &kNormalTrainingSequence1;
+    auto training_seq_offset = kNormalUplinkBurstTrainingSeqOffset;
+
+    switch (burst.burst_type) {
+    case BurstType::ControlUplinkBurst:
+        training_seq = &kExtendedTrainingSequence;
+        training_seq_offset = kControlUplinkBurstTrainingSeqOffset;
+        break;
+    case BurstType::NormalUplinkBurst:
+        break;
+    case BurstType::NormalUplinkBurstSplit:
+        training_seq = &kNormalTrainingSequence2;
+        break;
+    case BurstType::NormalDownlinkBurst:
+    case BurstType::NormalDownlinkBurstSplit:
+    case BurstType::SynchronizationBurst:
+        // downlink bursts are detected in the bit stream decoder
+        return;
+    }
+
+    const auto len = burst.symbols.size();
+
+    update_phase_offset(estimate_phase_offset(burst.symbols, *training_seq, training_seq_offset));
+
+    const auto taps = channel_estimation(burst.symbols, *training_seq, training_seq_offset);
+    const auto equalized = equalize(burst.symbols, taps);
+
+    std::vector<uint8_t> bits(len * 2);
+
+    symbols_to_bitstream(equalized.cbegin(), bits.data(), len);
+
+    auto lower_mac_process = std::bind(&LowerMac::process, lower_mac_, bits, burst.burst_type);
+    lower_mac_worker_queue_->queue_work(lower_mac_process);
+}
+
+void IQStreamDecoder::process_complex(const std::complex<float>* symbols, const std::size_t count) noexcept {
+    derotated_symbols_.resize(count);
+    complex_scale(symbols, std::polar(1.0F, -phase_offset_), derotated_symbols_.data(), count);
+
+    // The downlink bursts are only aligned after the bit stream decoder. Estimate the phase offset on the whole block.
+    if (!is_uplink_ && count > 0) {
+        update_phase_offset(estimate_phase_offset_blind(derotated_symbols_.data(), count));
+    }
+
+    for (const auto& symbol : derotated_symbols_) {
+        process_complex(symbol);
+    }
+}
+
+void IQStreamDecoder::process_complex(std::complex<float> symbol) noexcept {
+    if (is_uplink_) {
+        uplink_symbol_position_++;
+        uplink_burst_peak_picker_.advance(uplink_symbol_position_);
+
+        // Control Uplink Burst or Normal Uplink Burst
+        symbol_buffer_.push(symbol);
+        symbol_buffer_hard_decision_.push(hard_decision(symbol));
+
+        // correlate the hard decisions with the training sequences n, p and x to find potential correlation peaks. The
+        // bursts are detected and trained with the training sequence at the same offset. All potential bursts are
+        // passed to the peak picker, which only forwards the best detection of a burst.
+        //
+        // find CUB
+        detect_uplink_burst(BurstType::ControlUplinkBurst, kControlUplinkBurstLength,
+                            training_seq_correlation(symbol_buffer_hard_decision_, kControlUplinkBurstTrainingSeqOffset,
+                                                     kExtendedTrainingSequence),
+                            kExtendedTrainingSequence.size());
+        // find NUB_Split
+        detect_uplink_burst(BurstType::NormalUplinkBurstSplit, kNormalUplinkBurstLength,
+                            training_seq_correlation(symbol_buffer_hard_decision_, kNormalUplinkBurstTrainingSeqOffset,
+                                                     kNormalTrainingSequence2),
+                            kNormalTrainingSequence2.size());
+        // find NUB
+        detect_uplink_burst(BurstType::NormalUplinkBurst, kNormalUplinkBurstLength,
+                            training_seq_correlation(symbol_buffer_hard_decision_, kNormalUplinkBurstTrainingSeqOffset,
+                                                     kNormalTrainingSequence1),
+                            kNormalTrainingSequence1.size());
     } else {
         // TODO: this path needs to change!
         std::vector<std::complex<float>> stream = {symbol};
@@ -7,6 +7,7 @@
  */
 
 #include "l2/logical_link_control_packet.hpp"
+#include <utility>
 
 BasicLinkInformation::BasicLinkInformation(BitVector& data) {
     auto pdu_type = data.take<4>();
@@ -49,14 +50,14 @@ BasicLinkInformation::BasicLinkInformation(BitVector& data) {
     }
 }
 
-LogicalLinkControlPacket::LogicalLinkControlPacket(const UpperMacCPlaneSignallingPacket& packet)
-    : UpperMacCPlaneSignallingPacket(packet) {
+LogicalLinkControlPacket::LogicalLinkControlPacket(UpperMacCPlaneSignallingPacket&& packet)
+    : UpperMacCPlaneSignallingPacket(std::move(packet)) {
     auto data = BitVector(*tm_sdu_);
     auto pdu_type = data.look<4>(0);
 
     /// We only implemented packet parsing for Basic Link PDUs at this point in time
     if (pdu_type < 0b1000) {
         basic_link_information_ = BasicLinkInformation(data);
-        tl_sdu_ = data;
+        tl_sdu_ = std::move(data);
     }
 }
\ No newline at end of file
@@ -61,8 +61,7 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
         }
 
         auto bb_rm = LowerMacCoding::reed_muller_3014_decode(LowerMacCoding::descramble(bb_input, bsc.scrambling_code));
-        auto _aach =
-            AccessAssignmentChannel(burst_type, bsc.time, BitVector(std::vector(bb_rm.cbegin(), bb_rm.cend())));
+        auto _aach = AccessAssignmentChannel(burst_type, bsc.time, BitVector(bb_rm.cbegin(), bb_rm.cend()));
 
         // bkn2 block
         // ✅ done
@@ -78,10 +77,10 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
             viter_bi_codec_1614_, LowerMacCoding::depuncture23(LowerMacCoding::deinterleave(
                                       LowerMacCoding::descramble(bkn2_input, bsc.scrambling_code), 101)));
 
-        slots = Slots(burst_type, SlotType::kOneSubslot,
+        slots = Slots(burst_type, bsc.time, SlotType::kOneSubslot,
                       Slot(LogicalChannelDataAndCrc{
                           .channel = LogicalChannel::kSignallingChannelHalfDownlink,
-                          .data = BitVector(std::vector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124)),
+                          .data = BitVector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124),
                           .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn2_bits),
                       }));
     } else if (burst_type == BurstType::NormalDownlinkBurst) {
@@ -94,7 +93,7 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
         }
 
         auto bb_rm = LowerMacCoding::reed_muller_3014_decode(LowerMacCoding::descramble(bb_input, bsc.scrambling_code));
-        auto aach = AccessAssignmentChannel(burst_type, bsc.time, BitVector(std::vector(bb_rm.cbegin(), bb_rm.cend())));
+        auto aach = AccessAssignmentChannel(burst_type, bsc.time, BitVector(bb_rm.cbegin(), bb_rm.cend()));
 
         // TCH or SCH/F
         std::array<bool, 432> bkn1_input{};
@@ -110,19 +109,19 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
 
         if (aach.downlink_usage == DownlinkUsage::Traffic) {
             // Full slot traffic channel defined type 4 bits (only descrambling)
-            slots = Slots(burst_type, SlotType::kFullSlot,
+            slots = Slots(burst_type, bsc.time, SlotType::kFullSlot,
                           Slot(LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kTrafficChannel,
-                              .data = BitVector(std::vector(bkn1_descrambled.cbegin(), bkn1_descrambled.cend())),
+                              .data = BitVector(bkn1_descrambled.cbegin(), bkn1_descrambled.cend()),
                               .crc_ok = true,
                           }));
         } else {
             // control channel
             // ✅done
-            slots = Slots(burst_type, SlotType::kFullSlot,
+            slots = Slots(burst_type, bsc.time, SlotType::kFullSlot,
                           Slot(LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kSignallingChannelFull,
-                              .data = BitVector(std::vector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 268)),
+                              .data = BitVector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 268),
                               .crc_ok = LowerMacCoding::check_crc_16_ccitt<284>(bkn1_bits),
                           }));
         }
@@ -136,7 +135,7 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
         }
 
         auto bb_rm = LowerMacCoding::reed_muller_3014_decode(LowerMacCoding::descramble(bb_input, bsc.scrambling_code));
-        auto aach = AccessAssignmentChannel(burst_type, bsc.time, BitVector(std::vector(bb_rm.cbegin(), bb_rm.cend())));
+        auto aach = AccessAssignmentChannel(burst_type, bsc.time, BitVector(bb_rm.cbegin(), bb_rm.cend()));
 
         std::array<bool, 216> bkn1_input{};
         for (auto i = 0; i < 216; i++) {
@@ -162,34 +161,34 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
             // STCH + TCH
             // STCH + STCH
             slots =
-                Slots(burst_type, SlotType::kTwoSubslots,
+                Slots(burst_type, bsc.time, SlotType::kTwoSubslots,
                       Slot(LogicalChannelDataAndCrc{
                           .channel = LogicalChannel::kStealingChannel,
-                          .data = BitVector(std::vector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124)),
+                          .data = BitVector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124),
                           .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn1_bits),
                       }),
                       Slot({LogicalChannelDataAndCrc{
                                 .channel = LogicalChannel::kStealingChannel,
-                                .data = BitVector(std::vector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124)),
+                                .data = BitVector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124),
                                 .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn2_bits),
                             },
                             LogicalChannelDataAndCrc{
                                 .channel = LogicalChannel::kTrafficChannel,
-                                .data = BitVector(std::vector(bkn2_deinterleaved.cbegin(), bkn2_deinterleaved.cend())),
+                                .data = BitVector(bkn2_deinterleaved.cbegin(), bkn2_deinterleaved.cend()),
                                 .crc_ok = true,
                             }}));
         } else {
             // SCH/HD + SCH/HD
             // SCH/HD + BNCH
-            slots = Slots(burst_type, SlotType::kTwoSubslots,
+            slots = Slots(burst_type, bsc.time, SlotType::kTwoSubslots,
                           Slot(LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kSignallingChannelHalfDownlink,
-                              .data = BitVector(std::vector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124)),
+                              .data = BitVector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124),
                               .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn1_bits),
                           }),
                           Slot(LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kSignallingChannelHalfDownlink,
-                              .data = BitVector(std::vector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124)),
+                              .data = BitVector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124),
                               .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn2_bits),
                           }));
         }
@@ -205,10 +204,10 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
                                       LowerMacCoding::descramble(cb_input, bsc.scrambling_code), 13)));
 
         // SCH/HU
-        slots = Slots(burst_type, SlotType::kOneSubslot,
+        slots = Slots(burst_type, bsc.time, SlotType::kOneSubslot,
                       Slot(LogicalChannelDataAndCrc{
                           .channel = LogicalChannel::kSignallingChannelHalfUplink,
-                          .data = BitVector(std::vector(cb_bits.cbegin(), cb_bits.cbegin() + 92)),
+                          .data = BitVector(cb_bits.cbegin(), cb_bits.cbegin() + 92),
                           .crc_ok = LowerMacCoding::check_crc_16_ccitt<108>(cb_bits),
                       }));
     } else if (burst_type == BurstType::NormalUplinkBurst) {
@@ -225,16 +224,16 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
         auto bkn1_bits = LowerMacCoding::viter_bi_decode_1614(
             viter_bi_codec_1614_, LowerMacCoding::depuncture23(LowerMacCoding::deinterleave(bkn1_descrambled, 103)));
 
-        slots = Slots(burst_type, SlotType::kFullSlot,
+        slots = Slots(burst_type, bsc.time, SlotType::kFullSlot,
                       Slot({
                           LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kSignallingChannelFull,
-                              .data = BitVector(std::vector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 268)),
+                              .data = BitVector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 268),
                               .crc_ok = LowerMacCoding::check_crc_16_ccitt<284>(bkn1_bits),
                           },
                           LogicalChannelDataAndCrc{
                               .channel = LogicalChannel::kTrafficChannel,
-                              .data = BitVector(std::vector(bkn1_descrambled.cbegin(), bkn1_descrambled.cend())),
+                              .data = BitVector(bkn1_descrambled.cbegin(), bkn1_descrambled.cend()),
                               .crc_ok = true,
                           },
                       }));
@@ -260,20 +259,20 @@ auto LowerMac::processChannels(const std::vector<uint8_t>& frame, BurstType burs
 
         // STCH + TCH
         // STCH + STCH
-        slots = Slots(burst_type, SlotType::kTwoSubslots,
+        slots = Slots(burst_type, bsc.time, SlotType::kTwoSubslots,
                       Slot(LogicalChannelDataAndCrc{
                           .channel = LogicalChannel::kStealingChannel,
-                          .data = BitVector(std::vector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124)),
+                          .data = BitVector(bkn1_bits.cbegin(), bkn1_bits.cbegin() + 124),
                           .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn1_bits),
                       }),
                       Slot({LogicalChannelDataAndCrc{
                                 .channel = LogicalChannel::kStealingChannel,
-                                .data = BitVector(std::vector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124)),
+                                .data = BitVector(bkn2_bits.cbegin(), bkn2_bits.cbegin() + 124),
                                 .crc_ok = LowerMacCoding::check_crc_16_ccitt<140>(bkn2_bits),
                             },
                             LogicalChannelDataAndCrc{
                                 .channel = LogicalChannel::kTrafficChannel,
-                                .data = BitVector(std::vector(bkn2_deinterleaved.cbegin(), bkn2_deinterleaved.cend())),
+                                .data = BitVector(bkn2_deinterleaved.cbegin(), bkn2_deinterleaved.cend()),
                                 .crc_ok = true,
                             }}));
     } else {
@@ -313,8 +312,8 @@ auto LowerMac::process(std::vector<uint8_t> frame, BurstType burst_type) -> Lowe
                                       LowerMacCoding::deinterleave(LowerMacCoding::descramble(sb_input, 0x0003), 11)));
 
         if (LowerMacCoding::check_crc_16_ccitt<76>(sb_bits)) {
-            current_sync = BroadcastSynchronizationChannel(
-                burst_type, BitVector(std::vector(sb_bits.cbegin(), sb_bits.cbegin() + 60)));
+            current_sync =
+                BroadcastSynchronizationChannel(burst_type, BitVector(sb_bits.cbegin(), sb_bits.cbegin() + 60));
         } else {
             decode_error |= true;
         }
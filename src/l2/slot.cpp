@@ -17,8 +17,9 @@ auto operator<<(std::ostream& stream, const Slot& slot) -> std::ostream& {
     return stream;
 }
 
-Slots::Slots(BurstType burst_type, SlotType slot_type, Slot&& slot)
+Slots::Slots(BurstType burst_type, TimebaseCounter time, SlotType slot_type, Slot&& slot)
     : burst_type_(burst_type)
+    , time_(time)
     , slot_type_(slot_type)
     , slots_({std::move(slot)}) {
     if (slot_type_ == SlotType::kTwoSubslots) {
@@ -38,8 +39,9 @@ Slots::Slots(BurstType burst_type, SlotType slot_type, Slot&& slot)
 };
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-Slots::Slots(BurstType burst_type, SlotType slot_type, Slot&& first_slot, Slot&& second_slot)
+Slots::Slots(BurstType burst_type, TimebaseCounter time, SlotType slot_type, Slot&& first_slot, Slot&& second_slot)
     : burst_type_(burst_type)
+    , time_(time)
     , slot_type_(slot_type)
     , slots_({std::move(first_slot), std::move(second_slot)}) {
     if (slot_type_ != SlotType::kTwoSubslots) {
@@ -11,6 +11,10 @@
 #include "l2/lower_mac.hpp"
 #include "l2/upper_mac_fragments.hpp"
 #include "streaming_ordered_output_thread_pool_executor.hpp"
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
 #include <utility>
 
 #if defined(__linux__)
@@ -35,19 +39,44 @@ UpperMac::UpperMac(const std::shared_ptr<StreamingOrderedOutputThreadPoolExecuto
         fragmentation_metrics_downlink_stealing_channel_ =
             std::make_shared<UpperMacFragmentsPrometheusCounters>(prometheus_exporter, "Stealing Channel Downlink");
     }
-    downlink_fragmentation_ =
-        std::make_unique<UpperMacDownlinkFragmentation>(fragmentation_metrics_downlink_continous_);
-    uplink_fragmentation_ = std::make_unique<UpperMacUplinkFragmentation>(fragmentation_metrics_uplink_continous_);
+    for (auto& shard : reassembly_shards_) {
+        shard.downlink_fragmentation =
+            std::make_unique<UpperMacDownlinkFragmentation>(fragmentation_metrics_downlink_continous_);
+        shard.uplink_fragmentation =
+            std::make_unique<UpperMacUplinkFragmentation>(fragmentation_metrics_uplink_continous_);
+    }
+
+    slot_parser_ = std::make_unique<StreamingOrderedOutputThreadPoolExecutor<ParsedSlots>>(
+        slot_parser_termination_flag_, reassembly_termination_flag_, kParserWorkerCount);
+    packet_parser_ = std::make_unique<StreamingOrderedOutputThreadPoolExecutor<OutputElements>>(
+        packet_parser_termination_flag_, output_worker_termination_flag_, kParserWorkerCount);
 
     worker_thread_ = std::thread(&UpperMac::worker, this);
+    reassembly_thread_ = std::thread(&UpperMac::reassembly_worker, this);
+    output_thread_ = std::thread(&UpperMac::output_worker, this);
+    for (auto& shard : reassembly_shards_) {
+        shard.thread = std::thread(&UpperMac::reassembly_shard_worker, this, std::ref(shard));
+    }
 
 #if defined(__linux__)
-    auto handle = worker_thread_.native_handle();
-    pthread_setname_np(handle, "UpperMacWorker");
+    pthread_setname_np(worker_thread_.native_handle(), "UpperMacWorker");
+    pthread_setname_np(reassembly_thread_.native_handle(), "UpperMacReassembly");
+    pthread_setname_np(output_thread_.native_handle(), "UpperMacOutput");
+    for (std::size_t i = 0; i < kTimeslotCount; i++) {
+        auto thread_name = "UpperMacShard" + std::to_string(i);
+        pthread_setname_np(reassembly_shards_.at(i).thread.native_handle(), thread_name.c_str());
+    }
 #endif
 }
 
-UpperMac::~UpperMac() { worker_thread_.join(); }
+UpperMac::~UpperMac() {
+    worker_thread_.join();
+    reassembly_thread_.join();
+    for (auto& shard : reassembly_shards_) {
+        shard.thread.join();
+    }
+    output_thread_.join();
+}
 
 void UpperMac::worker() {
     for (;;) {
@@ -63,7 +92,76 @@ void UpperMac::worker() {
 
         auto slots = *return_value;
         if (slots) {
-            this->process(*slots);
+            slot_parser_->queue_work([this, slots = *slots]() { return parse_slots(slots); });
+        }
+    }
+
+    // forward the termination to the slot parser workers
+    slot_parser_termination_flag_.store(true);
+}
+
+void UpperMac::reassembly_worker() {
+    for (;;) {
+        auto parsed_slots = slot_parser_->get_or_null();
+
+        if (!parsed_slots) {
+            if (reassembly_termination_flag_.load() && slot_parser_->empty()) {
+                break;
+            }
+
+            continue;
+        }
+
+        // the network time starts with timeslot 1
+        const auto timeslot = (parsed_slots->slots.get_time().time_slot() - 1U) % kTimeslotCount;
+        auto& shard = reassembly_shards_.at(timeslot);
+
+        std::promise<ReassembledSlots> promise;
+        // std::function requires a copyable function, so the future is shared with the work item
+        auto reassembled_slots = std::make_shared<std::future<ReassembledSlots>>(promise.get_future());
+        shard.input_queue.push_back(std::make_pair(std::move(*parsed_slots), std::move(promise)));
+
+        // queue the parsing of the upper layers in the order of the slots. the packet parser workers wait for the
+        // reassembly shard to complete the fragment reconstruction of this burst.
+        packet_parser_->queue_work([this, reassembled_slots]() { return parse_packets(reassembled_slots->get()); });
+    }
+
+    // forward the termination to the reassembly shards and the packet parser workers
+    reassembly_shard_termination_flag_.store(true);
+    packet_parser_termination_flag_.store(true);
+}
+
+void UpperMac::reassembly_shard_worker(ReassemblyShard& shard) {
+    for (;;) {
+        auto work = shard.input_queue.get_or_null();
+
+        if (!work) {
+            if (reassembly_shard_termination_flag_.load() && shard.input_queue.empty()) {
+                break;
+            }
+
+            continue;
+        }
+
+        auto& [parsed_slots, promise] = *work;
+        promise.set_value(reassemble(shard, std::move(parsed_slots)));
+    }
+}
+
+void UpperMac::output_worker() {
+    for (;;) {
+        auto output_elements = packet_parser_->get_or_null();
+
+        if (!output_elements) {
+            if (output_worker_termination_flag_.load() && packet_parser_->empty()) {
+                break;
+            }
+
+            continue;
+        }
+
+        for (auto& element : *output_elements) {
+            output_queue_.push_back(std::move(element));
         }
     }
 
@@ -71,81 +169,80 @@ void UpperMac::worker() {
     output_termination_flag_.store(true);
 }
 
-auto UpperMac::process(const Slots& slots) -> void {
-    const auto concreate_slots = slots.get_concreate_slots();
+auto UpperMac::parse_slots(const Slots& slots) -> ParsedSlots {
+    ParsedSlots parsed_slots{.slots = slots};
+    auto& packets = parsed_slots.packets;
 
-    UpperMacPackets packets;
-    for (const auto& slot : concreate_slots) {
+    for (const auto& slot : parsed_slots.slots.get_concreate_slots()) {
         // increment the total count and crc error count metrics
         if (metrics_) {
             metrics_->increment(slot);
         }
 
-        try {
-            packets.merge(UpperMacPacketBuilder::parse_slot(slot));
-            // if (packets.has_user_or_control_plane_data()) {
-            //     std::cout << packets << std::endl;
-            // }
-        } catch (std::runtime_error& e) {
+        // malformed slots are frequent on noisy cells. they are reported without throwing an exception.
+        auto slot_packets = UpperMacPacketBuilder::try_parse_slot(slot);
+        if (!slot_packets) {
             if (metrics_) {
-                metrics_->increment_decode_error(slot);
+                metrics_->increment_parse_error(slot, slot_packets.error());
             }
-
             continue;
         }
+
+        if (auto error = packets.try_merge(std::move(*slot_packets))) {
+            if (metrics_) {
+                metrics_->increment_parse_error(slot, *error);
+            }
+        }
     }
 
     /// This step takes care of adding the correct adresses for some uplink packets.
     packets.apply_uplink_null_pdu_information();
 
-    try {
-        processPackets(std::move(packets));
-    } catch (std::runtime_error& e) {
-        if (metrics_) {
-            // if there was an error decoding the packets, report the error in the slots where the packets orginated
-            // from
-            for (const auto& slot : concreate_slots) {
-                metrics_->increment_decode_error(slot);
-            }
-            // send the broken slot to borzoi
-            output_queue_.push_back(slots);
-        }
-    }
+    return parsed_slots;
 }
 
-auto UpperMac::processPackets(UpperMacPackets&& packets) -> void {
+auto UpperMac::reassemble(ReassemblyShard& shard, ParsedSlots&& parsed_slots) -> ReassembledSlots {
+    const auto& packets = parsed_slots.packets;
+
     // the fragmentation reconstructor for over two stealing channel in the same burst
-    auto& downlink_fragmentation = *downlink_fragmentation_;
     auto stealling_channel_fragmentation =
         UpperMacDownlinkFragmentation(fragmentation_metrics_downlink_stealing_channel_,
                                       /*continuation_fragments_allowed=*/false);
 
     std::vector<UpperMacCPlaneSignallingPacket> c_plane_packets;
 
-    for (const auto& packet : packets.c_plane_signalling_packets_) {
-        // increment the packets for the mac packet type
-        if (metrics_) {
-            metrics_->increment_c_plane_packet_counters(packet);
-        }
+    // the uplink reassemblies age with the bursts of the shard
+    shard.uplink_fragmentation->next_burst();
 
-        if (packet.is_downlink_fragment()) {
-            /// populate the fragmenter for stealing channel
-            if (packet.fragmentation_on_stealling_channel_) {
-                downlink_fragmentation = stealling_channel_fragmentation;
+    try {
+        for (const auto& packet : packets.c_plane_signalling_packets_) {
+            // increment the packets for the mac packet type
+            if (metrics_) {
+                metrics_->increment_c_plane_packet_counters(packet);
             }
 
-            auto reconstructed_fragment = downlink_fragmentation.push_fragment(packet);
-            if (reconstructed_fragment) {
-                c_plane_packets.emplace_back(std::move(*reconstructed_fragment));
-            }
-        } else if (packet.is_uplink_fragment()) {
-            auto reconstructed_fragment = uplink_fragmentation_->push_fragment(packet);
-            if (reconstructed_fragment) {
-                c_plane_packets.emplace_back(std::move(*reconstructed_fragment));
+            if (packet.is_downlink_fragment()) {
+                /// select the fragmenter for stealing channel. the continous fragmenter of the shard keeps its state.
+                auto& downlink_fragmentation = packet.fragmentation_on_stealling_channel_
+                                                   ? stealling_channel_fragmentation
+                                                   : *shard.downlink_fragmentation;
+
+                auto reconstructed_fragment = downlink_fragmentation.push_fragment(packet);
+                if (reconstructed_fragment) {
+                    c_plane_packets.emplace_back(std::move(*reconstructed_fragment));
+                }
+            } else if (packet.is_uplink_fragment()) {
+                auto reconstructed_fragment = shard.uplink_fragmentation->push_fragment(packet);
+                if (reconstructed_fragment) {
+                    c_plane_packets.emplace_back(std::move(*reconstructed_fragment));
+                }
+            } else if (packet.tm_sdu_) {
+                c_plane_packets.emplace_back(packet);
             }
-        } else if (packet.tm_sdu_) {
-            c_plane_packets.emplace_back(packet);
         }
+    } catch (std::runtime_error& e) {
+        // the fragmenters only throw for packets that are not fragments
+        return ReassembledSlots{.slots = std::move(parsed_slots.slots), .decode_error = true};
     }
 
     /// increment the reconstruction error counter if we could not complete the fragmentation over stealing channel
@@ -158,9 +255,41 @@ auto UpperMac::processPackets(UpperMacPackets&& packets) -> void {
         metrics_->increment_packet_counters(packets);
     }
 
-    for (const auto& packet : c_plane_packets) {
-        auto llc = logical_link_control_.parse(packet);
+    return ReassembledSlots{.slots = std::move(parsed_slots.slots), .c_plane_packets = std::move(c_plane_packets)};
+}
+
+auto UpperMac::parse_packets(ReassembledSlots&& reassembled_slots) -> OutputElements {
+    if (reassembled_slots.decode_error) {
+        return decode_error(reassembled_slots.slots);
+    }
+
+    OutputElements output_elements;
 
-        output_queue_.push_back(std::move(llc));
+    // the LLC and the layers above report malformed PDUs with exceptions. they only see the packets that passed the
+    // upper MAC, so throwing is rare compared to the malformed slots that are rejected there.
+    try {
+        for (auto& packet : reassembled_slots.c_plane_packets) {
+            output_elements.emplace_back(logical_link_control_.parse(std::move(packet)));
+        }
+    } catch (std::runtime_error& e) {
+        auto failed_slots = decode_error(reassembled_slots.slots);
+        std::move(failed_slots.begin(), failed_slots.end(), std::back_inserter(output_elements));
     }
-}
\ No newline at end of file
+
+    return output_elements;
+}
+
+auto UpperMac::decode_error(const Slots& slots) -> OutputElements {
+    OutputElements output_elements;
+
+    if (metrics_) {
+        // if there was an error decoding the packets, report the error in the slots where the packets orginated from
+        for (const auto& slot : slots.get_concreate_slots()) {
+            metrics_->increment_decode_error(slot);
+        }
+        // send the broken slot to borzoi
+        output_elements.emplace_back(slots);
+    }
+
+    return output_elements;
+}
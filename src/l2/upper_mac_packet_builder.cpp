@@ -15,7 +15,7 @@
 #include <cstddef>
 #include <optional>
 #include <ostream>
-#include <stdexcept>
+#include <utility>
 
 auto operator<<(std::ostream& stream, const UpperMacPackets& packets) -> std::ostream& {
     stream << "[UpperMacPacket]" << std::endl;
@@ -40,6 +40,10 @@ auto operator<<(std::ostream& stream, const UpperMacPackets& packets) -> std::os
 }
 
 auto UpperMacPacketBuilder::parse_slot(const ConcreateSlot& slot) -> UpperMacPackets {
+    return try_parse_slot(slot).value();
+}
+
+auto UpperMacPacketBuilder::try_parse_slot(const ConcreateSlot& slot) -> ParseResult<UpperMacPackets> {
     const auto& channel = slot.logical_channel_data_and_crc.channel;
     auto data = BitVector(slot.logical_channel_data_and_crc.data);
     if (channel == LogicalChannel::kTrafficChannel) {
@@ -51,6 +55,9 @@ auto UpperMacPacketBuilder::parse_slot(const ConcreateSlot& slot) -> UpperMacPac
         return UpperMacPackets{};
     }
 
+    // truncated PDUs are checked after parsing instead of throwing
+    data.set_non_throwing();
+
     auto pdu_type = data.look<2>(0);
 
     // See "Table 21.38: MAC PDU types for SCH/F, SCH/HD, STCH, SCH-P8/F, SCH-P8/HD, SCH-Q/D, SCH-Q/B and SCH-Q/U" on
@@ -59,26 +66,41 @@ auto UpperMacPacketBuilder::parse_slot(const ConcreateSlot& slot) -> UpperMacPac
         if (pdu_type == 0b11) {
             // process MAC-U-SIGNAL
             // this takes the complete stealing channel
-            return UpperMacPackets{.u_plane_signalling_packet_ = {parse_u_plane_signalling(channel, std::move(data))}};
+            auto packet = parse_u_plane_signalling(channel, std::move(data));
+            if (!packet) {
+                return packet.error();
+            }
+            return UpperMacPackets{.u_plane_signalling_packet_ = {std::move(*packet)}};
+        }
+        auto packets = parse_c_plane_signalling(slot.burst_type, channel, std::move(data));
+        if (!packets) {
+            return packets.error();
         }
-        return UpperMacPackets{.c_plane_signalling_packets_ =
-                                   parse_c_plane_signalling(slot.burst_type, channel, std::move(data))};
+        return UpperMacPackets{.c_plane_signalling_packets_ = std::move(*packets)};
     }
 
     if (pdu_type == 0b10) {
         // Broadcast
         // TMB-SAP
         if (is_downlink_burst(slot.burst_type)) {
-            return UpperMacPackets{.broadcast_packet_ = parse_broadcast(channel, std::move(data))};
+            auto packet = parse_broadcast(channel, std::move(data));
+            if (!packet) {
+                return packet.error();
+            }
+            return UpperMacPackets{.broadcast_packet_ = std::move(*packet)};
         }
-        throw std::runtime_error("Broadcast may only be sent on downlink.");
+        return ParseError{ParseErrorCategory::kNotAllowed, "Broadcast may only be sent on downlink."};
     }
 
-    return UpperMacPackets{.c_plane_signalling_packets_ =
-                               parse_c_plane_signalling(slot.burst_type, channel, std::move(data))};
+    auto packets = parse_c_plane_signalling(slot.burst_type, channel, std::move(data));
+    if (!packets) {
+        return packets.error();
+    }
+    return UpperMacPackets{.c_plane_signalling_packets_ = std::move(*packets)};
 }
 
-auto UpperMacPacketBuilder::parse_broadcast(LogicalChannel channel, BitVector&& data) -> UpperMacBroadcastPacket {
+auto UpperMacPacketBuilder::parse_broadcast(LogicalChannel channel, BitVector&& data)
+    -> ParseResult<UpperMacBroadcastPacket> {
     UpperMacBroadcastPacket packet{.logical_channel_ = channel, .type_ = MacPacketType::kMacBroadcast};
 
     auto pdu_type = data.take<2>();
@@ -91,16 +113,17 @@ auto UpperMacPacketBuilder::parse_broadcast(LogicalChannel channel, BitVector&&
         // ACCESS-DEFINE PDU
         packet.access_define_ = AccessDefine(data);
     } else if (broadcast_type == 0b10) {
-        throw std::runtime_error("SYSINFO-DA is not implemented.");
+        return ParseError{ParseErrorCategory::kNotImplemented, "SYSINFO-DA is not implemented."};
     } else {
-        throw std::runtime_error("Reserved broadcast type");
+        return ParseError{ParseErrorCategory::kReservedValue, "Reserved broadcast type"};
+    }
+
+    if (data.truncated()) {
+        return ParseError{ParseErrorCategory::kTruncated, "Broadcast PDU is truncated."};
     }
 
     if (data.bits_left() != 0) {
-        std::cout << packet;
-        std::cout << data.bits_left() << " bits left over." << std::endl;
-        std::cout << data << std::endl;
-        throw std::runtime_error("Bits left after parsing broadcast PDU.");
+        return ParseError{ParseErrorCategory::kInvalidLength, "Bits left after parsing broadcast PDU."};
     }
 
     return packet;
@@ -108,7 +131,7 @@ auto UpperMacPacketBuilder::parse_broadcast(LogicalChannel channel, BitVector&&
 
 auto UpperMacPacketBuilder::extract_tm_sdu(BitVector& data, std::size_t preprocessing_bit_count,
                                            unsigned _BitInt(1) fill_bit_indication, std::optional<std::size_t> length)
-    -> BitVector {
+    -> ParseResult<BitVector> {
     // 1. calculate the header size of the MAC. this step must be performed before removing fill bits, as this would
     // change the number of bits in the BitVector
     const auto mac_header_length = preprocessing_bit_count - data.bits_left();
@@ -131,9 +154,9 @@ auto UpperMacPacketBuilder::extract_tm_sdu(BitVector& data, std::size_t preproce
             // cap the number of bits left to the maximum available. this should only happen if the
             // tm_sdu size + mac header size is not alligned to octect boundary
             if (payload_length - data.bits_left() >= 8) {
-                throw std::runtime_error(
-                    "Fill bits were indicated and the length indication shows a size that does not fit "
-                    "in the MAC, but the length indication is more than 7 bits apart.");
+                return ParseError{ParseErrorCategory::kInvalidLength,
+                                  "Fill bits were indicated and the length indication shows a size that does not fit "
+                                  "in the MAC, but the length indication is more than 7 bits apart."};
             }
             payload_length = data.bits_left();
         }
@@ -147,12 +170,14 @@ auto UpperMacPacketBuilder::extract_tm_sdu(BitVector& data, std::size_t preproce
 
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type, LogicalChannel channel,
-                                                            BitVector& data) -> UpperMacCPlaneSignallingPacket {
+                                                            BitVector& data)
+    -> ParseResult<UpperMacCPlaneSignallingPacket> {
     auto preprocessing_bit_count = data.bits_left();
 
     if (channel == LogicalChannel::kSignallingChannelHalfUplink) {
         if (is_downlink_burst(burst_type)) {
-            throw std::runtime_error("SignallingChannelHalfUplink may only be set on uplink.");
+            return ParseError{ParseErrorCategory::kNotAllowed,
+                              "SignallingChannelHalfUplink may only be set on uplink."};
         }
 
         auto pdu_type = data.take<1>();
@@ -184,8 +209,12 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                 return packet;
             }
 
-            packet.tm_sdu_ =
+            auto tm_sdu =
                 UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -204,8 +233,12 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                 packet.reservation_requirement_ = data.take<4>();
             }
 
-            packet.tm_sdu_ =
+            auto tm_sdu =
                 UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -250,8 +283,12 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                 return packet;
             }
 
-            packet.tm_sdu_ =
+            auto tm_sdu =
                 UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -262,14 +299,17 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
             auto subtype = data.take<1>();
             if (subtype == 0b0) {
                 if (channel == LogicalChannel::kStealingChannel) {
-                    throw std::runtime_error("MAC-FRAG may not be sent on stealing channel.");
+                    return ParseError{ParseErrorCategory::kNotAllowed, "MAC-FRAG may not be sent on stealing channel."};
                 }
 
                 UpperMacCPlaneSignallingPacket packet(burst_type, channel, MacPacketType::kMacFragmentUplink);
 
                 auto fill_bit_indication = data.take<1>();
-                packet.tm_sdu_ =
-                    UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+                auto tm_sdu = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+                if (!tm_sdu) {
+                    return tm_sdu.error();
+                }
+                packet.tm_sdu_ = std::move(*tm_sdu);
 
                 return packet;
             }
@@ -290,15 +330,20 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                     length = LengthIndication::from_mac_end_uplink(length_indictaion_or_reservation_requirement);
                 }
 
-                packet.tm_sdu_ =
+                auto tm_sdu =
                     UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+                if (!tm_sdu) {
+                    return tm_sdu.error();
+                }
+                packet.tm_sdu_ = std::move(*tm_sdu);
 
                 return packet;
             }
         }
 
         if (pdu_type == 0b10) {
-            throw std::runtime_error("Broadcast PDU should not be handled in parseCPlaneSignallingPacket function!");
+            return ParseError{ParseErrorCategory::kNotAllowed,
+                              "Broadcast PDU should not be handled in parseCPlaneSignallingPacket function!"};
         }
 
         {
@@ -306,11 +351,11 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
             auto subtype = data.take<1>();
 
             if (subtype == 0b1) {
-                throw std::runtime_error("Supplementary MAC PDU subtype 0b1 is reserved.");
+                return ParseError{ParseErrorCategory::kReservedValue, "Supplementary MAC PDU subtype 0b1 is reserved."};
             }
 
             if (channel != LogicalChannel::kSignallingChannelFull) {
-                throw std::runtime_error("MAC-U-BLCK may only be sent on SCH/F.");
+                return ParseError{ParseErrorCategory::kNotAllowed, "MAC-U-BLCK may only be sent on SCH/F."};
             }
 
             UpperMacCPlaneSignallingPacket packet(burst_type, channel, MacPacketType::kMacUBlck);
@@ -321,7 +366,11 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
             packet.address_.set_event_label(event_label);
             packet.reservation_requirement_ = data.take<4>();
 
-            packet.tm_sdu_ = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+            auto tm_sdu = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -389,8 +438,12 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                 packet.channel_allocation_element_ = ChannelAllocationElement(data);
             }
 
-            packet.tm_sdu_ =
+            auto tm_sdu =
                 UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -401,15 +454,18 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
             auto subtype = data.take<1>();
             if (subtype == 0b0) {
                 if (channel == LogicalChannel::kStealingChannel) {
-                    throw std::runtime_error("MAC-FRAG may not be sent on stealing channel.");
+                    return ParseError{ParseErrorCategory::kNotAllowed, "MAC-FRAG may not be sent on stealing channel."};
                 }
 
                 UpperMacCPlaneSignallingPacket packet(burst_type, channel, MacPacketType::kMacFragmentDownlink);
 
                 auto fill_bit_indication = data.take<1>();
 
-                packet.tm_sdu_ =
-                    UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+                auto tm_sdu = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+                if (!tm_sdu) {
+                    return tm_sdu.error();
+                }
+                packet.tm_sdu_ = std::move(*tm_sdu);
 
                 return packet;
             }
@@ -442,15 +498,20 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                     packet.channel_allocation_element_ = ChannelAllocationElement(data);
                 }
 
-                packet.tm_sdu_ =
+                auto tm_sdu =
                     UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication, length);
+                if (!tm_sdu) {
+                    return tm_sdu.error();
+                }
+                packet.tm_sdu_ = std::move(*tm_sdu);
 
                 return packet;
             }
         }
 
         if (pdu_type == 0b10) {
-            throw std::runtime_error("Broadcast PDU should not be handled in parseCPlaneSignallingPacket function!");
+            return ParseError{ParseErrorCategory::kNotAllowed,
+                              "Broadcast PDU should not be handled in parseCPlaneSignallingPacket function!"};
         }
 
         {
@@ -458,11 +519,11 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
             auto subtype = data.take<1>();
 
             if (subtype == 0b1) {
-                throw std::runtime_error("Supplementary MAC PDU subtype 0b1 is reserved.");
+                return ParseError{ParseErrorCategory::kReservedValue, "Supplementary MAC PDU subtype 0b1 is reserved."};
             }
 
             if (channel != LogicalChannel::kSignallingChannelFull) {
-                throw std::runtime_error("MAC-D-BLCK may only be sent on SCH/F.");
+                return ParseError{ParseErrorCategory::kNotAllowed, "MAC-D-BLCK may only be sent on SCH/F."};
             }
 
             UpperMacCPlaneSignallingPacket packet(burst_type, channel, MacPacketType::kMacDBlck);
@@ -482,7 +543,11 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
                 packet.basic_slot_granting_element_ = data.take<8>();
             }
 
-            packet.tm_sdu_ = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+            auto tm_sdu = UpperMacPacketBuilder::extract_tm_sdu(data, preprocessing_bit_count, fill_bit_indication);
+            if (!tm_sdu) {
+                return tm_sdu.error();
+            }
+            packet.tm_sdu_ = std::move(*tm_sdu);
 
             return packet;
         }
@@ -490,7 +555,8 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling_packet(BurstType burst_type
 }
 
 auto UpperMacPacketBuilder::parse_c_plane_signalling(const BurstType burst_type, const LogicalChannel channel,
-                                                     BitVector&& data) -> std::vector<UpperMacCPlaneSignallingPacket> {
+                                                     BitVector&& data)
+    -> ParseResult<std::vector<UpperMacCPlaneSignallingPacket>> {
 
     std::vector<UpperMacCPlaneSignallingPacket> packets;
 
@@ -516,7 +582,13 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling(const BurstType burst_type,
             break;
         }
         auto packet = parse_c_plane_signalling_packet(burst_type, channel, data);
-        packets.emplace_back(std::move(packet));
+        if (!packet) {
+            return packet.error();
+        }
+        if (data.truncated()) {
+            return ParseError{ParseErrorCategory::kTruncated, "C-plane signalling PDU is truncated."};
+        }
+        packets.emplace_back(std::move(*packet));
 
         // The Null PDU indicates that there is no more useful data in this MAC block; after receipt of the Null PDU,
         // the MAC shall not look for further information in the block.
@@ -528,18 +600,24 @@ auto UpperMacPacketBuilder::parse_c_plane_signalling(const BurstType burst_type,
 }
 
 auto UpperMacPacketBuilder::parse_u_plane_signalling(const LogicalChannel channel, BitVector&& data)
-    -> UpperMacUPlaneSignallingPacket {
+    -> ParseResult<UpperMacUPlaneSignallingPacket> {
     // the only valid packet here is MAC-U-SIGNAL
 
     auto pdu_type = data.take<2>();
     auto second_slot_stolen = data.take<1>();
 
     if (pdu_type != 0b11) {
-        throw std::runtime_error("UPlane Signalling Packet may only be MAC-U-SIGNAL");
+        return ParseError{ParseErrorCategory::kNotAllowed, "UPlane Signalling Packet may only be MAC-U-SIGNAL"};
+    }
+
+    if (data.truncated()) {
+        return ParseError{ParseErrorCategory::kTruncated, "MAC-U-SIGNAL is truncated."};
     }
 
-    return UpperMacUPlaneSignallingPacket{
-        .logical_channel_ = channel, .type_ = MacPacketType::kMacUSignal, .tm_sdu_ = std::move(data)};
+    // slice the remaining bits, so the TM-SDU throws again in the upper layers
+    return UpperMacUPlaneSignallingPacket{.logical_channel_ = channel,
+                                          .type_ = MacPacketType::kMacUSignal,
+                                          .tm_sdu_ = data.take_vector(data.bits_left())};
 }
 
 auto UpperMacPacketBuilder::parse_u_plane_traffic(const LogicalChannel channel, BitVector&& data)
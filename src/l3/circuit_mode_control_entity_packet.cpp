@@ -7,6 +7,14 @@
  */
 
 #include "l3/circuit_mode_control_entity_packet.hpp"
+#include <utility>
+
+namespace {
+/// The type 3 elements that are allowed in D-SDS-DATA and U-SDS-DATA
+constexpr Type234Parser<CircuitModeControlEntityType3ElementIdentifiers>::ElementIdentifierSet kSdsDataType3Elements = {
+    CircuitModeControlEntityType3ElementIdentifiers::kExternalSubsriberNumber,
+    CircuitModeControlEntityType3ElementIdentifiers::kDmMsAddress};
+} // namespace
 
 auto SdsData::from_d_sds_data(BitVector& data) -> SdsData {
     SdsData sds;
@@ -38,11 +46,7 @@ auto SdsData::from_d_sds_data(BitVector& data) -> SdsData {
         break;
     }
     sds.data_ = data.take_vector(length_identifier);
-    auto parser = Type234Parser<CircuitModeControlEntityType3ElementIdentifiers>(
-        data,
-        {CircuitModeControlEntityType3ElementIdentifiers::kExternalSubsriberNumber,
-         CircuitModeControlEntityType3ElementIdentifiers::kDmMsAddress},
-        {});
+    auto parser = Type234Parser<CircuitModeControlEntityType3ElementIdentifiers>(data, kSdsDataType3Elements, {});
     sds.optional_elements_ = parser.parse_type34(data);
 
     return sds;
@@ -81,18 +85,14 @@ auto SdsData::from_u_sds_data(BitVector& data) -> SdsData {
         break;
     }
     sds.data_ = data.take_vector(length_identifier);
-    auto parser = Type234Parser<CircuitModeControlEntityType3ElementIdentifiers>(
-        data,
-        {CircuitModeControlEntityType3ElementIdentifiers::kExternalSubsriberNumber,
-         CircuitModeControlEntityType3ElementIdentifiers::kDmMsAddress},
-        {});
+    auto parser = Type234Parser<CircuitModeControlEntityType3ElementIdentifiers>(data, kSdsDataType3Elements, {});
     sds.optional_elements_ = parser.parse_type34(data);
 
     return sds;
 }
 
-CircuitModeControlEntityPacket::CircuitModeControlEntityPacket(const MobileLinkEntityPacket& packet)
-    : MobileLinkEntityPacket(packet) {
+CircuitModeControlEntityPacket::CircuitModeControlEntityPacket(MobileLinkEntityPacket&& packet)
+    : MobileLinkEntityPacket(std::move(packet)) {
     auto data = BitVector(sdu_);
 
     auto pdu_type = data.take<5>();
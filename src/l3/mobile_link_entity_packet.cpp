@@ -7,9 +7,10 @@
  */
 
 #include "l3/mobile_link_entity_packet.hpp"
+#include <utility>
 
-MobileLinkEntityPacket::MobileLinkEntityPacket(const LogicalLinkControlPacket& packet)
-    : LogicalLinkControlPacket(packet) {
+MobileLinkEntityPacket::MobileLinkEntityPacket(LogicalLinkControlPacket&& packet)
+    : LogicalLinkControlPacket(std::move(packet)) {
     sdu_ = BitVector(tl_sdu_);
 
     auto discriminator = sdu_.take<3>();
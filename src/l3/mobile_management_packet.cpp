@@ -9,6 +9,32 @@
 #include "l3/mobile_management_packet.hpp"
 #include "utils/address.hpp"
 #include "utils/bit_vector.hpp"
+#include <utility>
+
+namespace {
+using ElementIdentifierSet = Type234Parser<MobileManagementDownlinkType34ElementIdentifiers>::ElementIdentifierSet;
+
+/// The type 3 elements that are allowed in D-ATTACH/DETACH GROUP IDENTITY ACKNOWLEDGEMENT
+constexpr ElementIdentifierSet kAttachDetachGroupIdentityAcknowledgementType3Elements = {
+    MobileManagementDownlinkType34ElementIdentifiers::kProprietary};
+/// The type 4 elements that are allowed in D-ATTACH/DETACH GROUP IDENTITY ACKNOWLEDGEMENT
+constexpr ElementIdentifierSet kAttachDetachGroupIdentityAcknowledgementType4Elements = {
+    MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentityDownlink,
+    MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentitySecurityRelatedInformation};
+
+/// The type 3 elements that are allowed in D-LOCATION UPDATE ACCEPT
+constexpr ElementIdentifierSet kLocationUpdateAcceptType3Elements = {
+    MobileManagementDownlinkType34ElementIdentifiers::kSecurityDownlink,
+    MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentityLocationAccept,
+    MobileManagementDownlinkType34ElementIdentifiers::kDefaultGroupAttachLifetime,
+    MobileManagementDownlinkType34ElementIdentifiers::kAuthenticationDownlink,
+    MobileManagementDownlinkType34ElementIdentifiers::kCellTypeControl,
+    MobileManagementDownlinkType34ElementIdentifiers::kProprietary};
+/// The type 4 elements that are allowed in D-LOCATION UPDATE ACCEPT
+constexpr ElementIdentifierSet kLocationUpdateAcceptType4Elements = {
+    MobileManagementDownlinkType34ElementIdentifiers::kNewRegisteredArea,
+    MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentitySecurityRelatedInformation};
+} // namespace
 
 struct ShortSubscriberIdentity {
   public:
@@ -59,24 +85,15 @@ MobileManagementDownlinkAttachDetachGroupIdentityAcknowledgement::
     : group_identity_accept_reject_(GroupIdentityAcceptReject(data.take<1>())) {
     auto reserved = data.take<1>();
     auto parser = Type234Parser<MobileManagementDownlinkType34ElementIdentifiers>(
-        data, {MobileManagementDownlinkType34ElementIdentifiers::kProprietary},
-        {MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentityDownlink,
-         MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentitySecurityRelatedInformation});
+        data, kAttachDetachGroupIdentityAcknowledgementType3Elements,
+        kAttachDetachGroupIdentityAcknowledgementType4Elements);
     optional_elements_ = parser.parse_type34(data);
 };
 
 MobileManagementDownlinkLocationUpdateAccept::MobileManagementDownlinkLocationUpdateAccept(BitVector& data)
     : location_update_accept_type_(LocationUpdateAcceptType(data.take<4>())) {
     auto parser = Type234Parser<MobileManagementDownlinkType34ElementIdentifiers>(
-        data,
-        {MobileManagementDownlinkType34ElementIdentifiers::kSecurityDownlink,
-         MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentityLocationAccept,
-         MobileManagementDownlinkType34ElementIdentifiers::kDefaultGroupAttachLifetime,
-         MobileManagementDownlinkType34ElementIdentifiers::kAuthenticationDownlink,
-         MobileManagementDownlinkType34ElementIdentifiers::kCellTypeControl,
-         MobileManagementDownlinkType34ElementIdentifiers::kProprietary},
-        {MobileManagementDownlinkType34ElementIdentifiers::kNewRegisteredArea,
-         MobileManagementDownlinkType34ElementIdentifiers::kGroupIdentitySecurityRelatedInformation});
+        data, kLocationUpdateAcceptType3Elements, kLocationUpdateAcceptType4Elements);
 
     address_.merge(parser.parse_type2<ShortSubscriberIdentity>(data));
     address_.merge(parser.parse_type2<MobileNetworkInformation>(data));
@@ -89,8 +106,8 @@ MobileManagementDownlinkLocationUpdateAccept::MobileManagementDownlinkLocationUp
     optional_elements_ = parser.parse_type34(data);
 };
 
-MobileManagementPacket::MobileManagementPacket(const MobileLinkEntityPacket& packet)
-    : MobileLinkEntityPacket(packet) {
+MobileManagementPacket::MobileManagementPacket(MobileLinkEntityPacket&& packet)
+    : MobileLinkEntityPacket(std::move(packet)) {
     auto data = BitVector(sdu_);
     auto pdu_type = data.take<4>();
     if (is_downlink()) {
@@ -7,6 +7,7 @@
  */
 
 #include "l3/short_data_service_packet.hpp"
+#include <utility>
 
 static auto integer_to_double(uint32_t data, std::size_t bits, double multiplier) -> double {
     if (data & (1 << (bits - 1))) {
@@ -69,8 +70,8 @@ LocationInformationProtocol::LocationInformationProtocol(BitVector& data)
     }
 }
 
-ShortDataServicePacket::ShortDataServicePacket(const CircuitModeControlEntityPacket& packet)
-    : CircuitModeControlEntityPacket(packet) {
+ShortDataServicePacket::ShortDataServicePacket(CircuitModeControlEntityPacket&& packet)
+    : CircuitModeControlEntityPacket(std::move(packet)) {
     assert(sds_data_.has_value());
     auto data = BitVector(sds_data_->data_);
 
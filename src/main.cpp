@@ -1,5 +1,6 @@
 #include "decoder.hpp"
 #include "signal_handler.hpp"
+#include <chrono>
 #include <csignal>
 #include <cstdlib>
 #include <cxxopts.hpp>
@@ -17,10 +18,14 @@ auto main(int argc, char** argv) -> int {
     unsigned int receive_port;
     bool packed;
     bool iq_or_bit_stream;
+    IQFormat iq_format;
     std::optional<std::string> input_file;
     std::optional<std::string> output_file;
+    std::optional<std::string> transmit_destination;
+    std::size_t transmit_queue_capacity;
     std::string borzoi_url;
     std::string borzoi_uuid;
+    BorzoiSenderOptions borzoi_sender_options;
     std::optional<unsigned> uplink_scrambling_code;
     std::optional<std::string> prometheus_address;
     std::optional<std::string> prometheus_name;
@@ -37,13 +42,28 @@ auto main(int argc, char** argv) -> int {
 	options.add_options()
 		("h,help", "Print usage")
 		("r,rx", "<UDP socket> receiving from phy", cxxopts::value<unsigned>()->default_value("42000"))
-		("t,tx", "<UDP socket> sending Json data", cxxopts::value<unsigned>()->default_value("42100"))		
+		("t,tx", "<destination> send every packet as a json datagram to <port> on localhost, <host>:<port> or the Unix datagram socket unix:<path>", cxxopts::value<std::optional<std::string>>(transmit_destination))
+		("tx-queue-capacity", "<packets> the maximum number of packets waiting to be sent as datagrams. Further packets are dropped", cxxopts::value<std::size_t>(transmit_queue_capacity)->default_value("1000"))
 		("borzoi-url", "<borzoi-url> the base url of which borzoi is running", cxxopts::value<std::string>(borzoi_url)->default_value("http://localhost:3000"))
 		("borzoi-uuid", "<borzoi-uuid> the UUID of this tetra-decoder sending data to borzoi", cxxopts::value<std::string>(borzoi_uuid)->default_value("00000000-0000-0000-0000-000000000000"))
+		("borzoi-queue-capacity", "<packets> the maximum number of packets waiting to be sent to borzoi or to be spooled. Further packets are dropped", cxxopts::value<std::size_t>(borzoi_sender_options.queue_capacity)->default_value("100000"))
+		("borzoi-wire-format", "<format> the encoding of the packets sent to borzoi: json, cbor or msgpack", cxxopts::value<std::string>()->default_value("json"))
+		("borzoi-compression", "<encoding> compress the requests sent to borzoi: none, gzip or deflate. Most useful with --borzoi-batch-size", cxxopts::value<std::string>()->default_value("none"))
+		("borzoi-compression-level", "<level> the zlib compression level from 0 (fastest) to 9 (smallest) or -1 for the zlib default", cxxopts::value<int>(borzoi_sender_options.compression_level)->default_value("-1"))
+		("borzoi-batch-size", "<packets> the maximum number of packets sent to borzoi in one request. If larger than one, the packets are sent as a json array", cxxopts::value<std::size_t>(borzoi_sender_options.batch_size)->default_value("1"))
+		("borzoi-batch-latency", "<milliseconds> the maximum time a packet waits for a batch to fill before it is sent to borzoi", cxxopts::value<unsigned>()->default_value("100"))
+		("borzoi-connections", "<connections> the number of connections on which requests are sent to borzoi concurrently. The packets of one mobile station are always sent in order", cxxopts::value<std::size_t>(borzoi_sender_options.connection_count)->default_value("1"))
+		("borzoi-max-in-flight", "<requests> the maximum number of requests that are queued or sent to borzoi on all connections", cxxopts::value<std::size_t>(borzoi_sender_options.max_in_flight)->default_value("16"))
+		("borzoi-spool-dir", "<directory> spool packets that could not be sent to borzoi to this directory and replay them in order once borzoi is reachable again. Packets may be sent twice after a restart", cxxopts::value<std::optional<std::string>>(borzoi_sender_options.spool_directory))
+		("borzoi-spool-max-bytes", "<bytes> the maximum size of the spool on the disk. The oldest packets are dropped when it is full", cxxopts::value<std::size_t>(borzoi_sender_options.spool_max_bytes)->default_value("1073741824"))
+		("borzoi-spool-segment-bytes", "<bytes> the size of a segment file of the spool", cxxopts::value<std::size_t>(borzoi_sender_options.spool_segment_bytes)->default_value("16777216"))
+		("borzoi-spool-sync", "<policy> when the spool is flushed to the disk: none, segment (when a segment is full) or always (after every packet)", cxxopts::value<std::string>()->default_value("segment"))
+		("borzoi-spool-queue-threshold", "<packets> the number of packets waiting for borzoi above which new packets are written to the spool", cxxopts::value<std::size_t>(borzoi_sender_options.spool_queue_threshold)->default_value("10000"))
 		("i,infile", "<file> replay data from binary file instead of UDP", cxxopts::value<std::optional<std::string>>(input_file))
 		("o,outfile", "<file> record data to binary file (can be replayed with -i option)", cxxopts::value<std::optional<std::string>>(output_file))
 		("P,packed", "pack rx data (1 byte = 8 bits)", cxxopts::value<bool>()->default_value("false"))
 		("iq", "Receive IQ instead of bitstream", cxxopts::value<bool>()->default_value("false"))
+		("iq-format", "<format> sample format of the IQ stream: cf32 (complex float), cs16 (complex int16) or cs8 (complex int8)", cxxopts::value<std::string>()->default_value("cf32"))
 		("uplink", "<scrambling code> enable uplink parsing with predefined scrambilng code", cxxopts::value<std::optional<unsigned>>(uplink_scrambling_code))
 		("prometheus-address", "<prometheus-address> on which ip and port the webserver for prometheus should listen. example: 127.0.0.1:9010", cxxopts::value<std::optional<std::string>>(prometheus_address))
 		("prometheus-name", "<prometheus-name> the name which is included in the prometheus metrics", cxxopts::value<std::optional<std::string>>(prometheus_name))
@@ -62,6 +82,21 @@ auto main(int argc, char** argv) -> int {
 
         packed = result["packed"].as<bool>();
         iq_or_bit_stream = result["iq"].as<bool>();
+        iq_format = iq_format_from_string(result["iq-format"].as<std::string>());
+        borzoi_sender_options.wire_format =
+            borzoi_wire_format_from_string(result["borzoi-wire-format"].as<std::string>());
+        borzoi_sender_options.compression =
+            borzoi_compression_from_string(result["borzoi-compression"].as<std::string>());
+        borzoi_sender_options.batch_max_latency =
+            std::chrono::milliseconds(result["borzoi-batch-latency"].as<unsigned>());
+        borzoi_sender_options.spool_sync_policy =
+            borzoi_spool_sync_policy_from_string(result["borzoi-spool-sync"].as<std::string>());
+
+        // the sinks are created after the decoding threads are started, check their options before
+        BorzoiSender::check_options(borzoi_sender_options);
+        if (transmit_destination) {
+            DatagramSink::check_destination(*transmit_destination);
+        }
 
         if (prometheus_address) {
             prometheus_exporter = std::make_shared<PrometheusExporter>(
@@ -72,8 +107,9 @@ auto main(int argc, char** argv) -> int {
         return EXIT_FAILURE;
     }
 
-    auto decoder = std::make_unique<Decoder>(receive_port, borzoi_url, borzoi_uuid, packed, input_file, output_file,
-                                             iq_or_bit_stream, uplink_scrambling_code, prometheus_exporter);
+    auto decoder = std::make_unique<Decoder>(receive_port, transmit_destination, transmit_queue_capacity, borzoi_url,
+                                             borzoi_uuid, borzoi_sender_options, packed, input_file, output_file,
+                                             iq_or_bit_stream, iq_format, uplink_scrambling_code, prometheus_exporter);
 
     if (input_file.has_value()) {
         std::cout << "Reading from input file " << *input_file << std::endl;
@@ -81,6 +117,12 @@ auto main(int argc, char** argv) -> int {
         std::cout << "Listening on UDP socket " << receive_port << std::endl;
     }
     std::cout << "Sending to Borzoi on: " << borzoi_url << std::endl;
+    if (transmit_destination.has_value()) {
+        std::cout << "Sending json datagrams to " << *transmit_destination << std::endl;
+    }
+    if (borzoi_sender_options.spool_directory.has_value()) {
+        std::cout << "Spooling undelivered packets to " << *borzoi_sender_options.spool_directory << std::endl;
+    }
     if (output_file.has_value()) {
         std::cout << "Writing to output file " << *output_file << std::endl;
     }
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "output/output_fan_out.hpp"
+#include "borzoi/borzoi_packets.hpp"
+#include "nlohmann/borzoi_send_tetra_packet.hpp" // IWYU pragma: keep
+#include "nlohmann/borzoi_send_tetra_slots.hpp"  // IWYU pragma: keep
+#include <chrono>
+#include <type_traits>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+OutputFanOut::OutputFanOut(ThreadSafeFifo<std::variant<std::unique_ptr<LogicalLinkControlPacket>, Slots>>& queue,
+                           std::atomic_bool& termination_flag, std::atomic_bool& output_termination_flag,
+                           std::string station_uuid, std::vector<std::shared_ptr<OutputSinkQueue>> sinks,
+                           bool serialize_json_text)
+    : queue_(queue)
+    , termination_flag_(termination_flag)
+    , output_termination_flag_(output_termination_flag)
+    , station_uuid_(std::move(station_uuid))
+    , sinks_(std::move(sinks))
+    , serialize_json_text_(serialize_json_text) {
+    worker_thread_ = std::thread(&OutputFanOut::worker, this);
+
+#if defined(__linux__)
+    auto handle = worker_thread_.native_handle();
+    pthread_setname_np(handle, "OutputFanOut");
+#endif
+}
+
+OutputFanOut::~OutputFanOut() { worker_thread_.join(); }
+
+auto OutputFanOut::worker() -> void {
+    for (;;) {
+        const auto return_value = queue_.get_or_null();
+
+        if (!return_value) {
+            if (termination_flag_.load() && queue_.empty()) {
+                break;
+            }
+
+            continue;
+        }
+
+        auto packet = std::make_shared<OutputPacket>();
+        std::visit(
+            [this, &packet](const auto& arg) {
+                using T = std::decay_t<decltype(arg)>;
+                if constexpr (std::is_same_v<T, std::unique_ptr<LogicalLinkControlPacket>>) {
+                    packet->endpoint = BorzoiEndpoint::kPacket;
+                    // the packets of a mobile station are kept in order
+                    packet->route = arg->address_.key().hash();
+                    packet->json = BorzoiSendTetraPacket(arg, station_uuid_);
+                } else if constexpr (std::is_same_v<T, Slots>) {
+                    packet->endpoint = BorzoiEndpoint::kFailedSlots;
+                    // the failed slots are kept in order
+                    packet->route = 0;
+                    packet->json = BorzoiSendTetraSlots(arg, station_uuid_);
+                }
+            },
+            *return_value);
+
+        if (serialize_json_text_) {
+            packet->json_text = packet->json.dump();
+        }
+        packet->created = std::chrono::steady_clock::now();
+
+        const std::shared_ptr<const OutputPacket> shared_packet = std::move(packet);
+        for (const auto& sink : sinks_) {
+            sink->push(shared_packet);
+        }
+    }
+
+    // all packets are in the queues of the sinks. let them finish their work.
+    output_termination_flag_ = true;
+}
@@ -32,6 +32,14 @@ auto PrometheusExporter::burst_lower_mac_mismatch_count() noexcept -> prometheus
         .Register(*registry_);
 }
 
+auto PrometheusExporter::burst_duplicate_suppressed_count() noexcept -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("burst_duplicate_suppressed_count")
+        .Help("Incrementing counter of the suppressed duplicate detections of uplink bursts")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
 auto PrometheusExporter::lower_mac_time_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
     return prometheus::BuildGauge()
         .Name("lower_mac_time_gauge")
@@ -40,6 +48,14 @@ auto PrometheusExporter::lower_mac_time_gauge() noexcept -> prometheus::Family<p
         .Register(*registry_);
 }
 
+auto PrometheusExporter::iq_frequency_offset_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("iq_frequency_offset_gauge")
+        .Help("The gauge for the carrier frequency offset of the IQ stream in Hz")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
 auto PrometheusExporter::upper_mac_total_slot_count() noexcept -> prometheus::Family<prometheus::Counter>& {
     return prometheus::BuildCounter()
         .Name("upper_mac_total_slot_count")
@@ -56,6 +72,14 @@ auto PrometheusExporter::upper_mac_slot_error_count() noexcept -> prometheus::Fa
         .Register(*registry_);
 }
 
+auto PrometheusExporter::upper_mac_parse_error_count() noexcept -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("upper_mac_parse_error_count")
+        .Help("Incrementing counter of the number of parse errors in the upper MAC by category.")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
 auto PrometheusExporter::upper_mac_fragment_count() noexcept -> prometheus::Family<prometheus::Counter>& {
     return prometheus::BuildCounter()
         .Name("upper_mac_fragment_count")
@@ -64,6 +88,23 @@ auto PrometheusExporter::upper_mac_fragment_count() noexcept -> prometheus::Fami
         .Register(*registry_);
 }
 
+auto PrometheusExporter::upper_mac_fragment_reassembly_live() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("upper_mac_fragment_reassembly_live")
+        .Help("The gauge for the number of c-plane packets that are currently being reassembled in the upper MAC.")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::upper_mac_fragment_reassembly_evicted_count() noexcept
+    -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("upper_mac_fragment_reassembly_evicted_count")
+        .Help("Incrementing counter of the number of abandoned reassemblies of c-plane packets in the upper MAC.")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
 auto PrometheusExporter::packet_count(const std::string& protocol) noexcept
     -> prometheus::Family<prometheus::Counter>& {
     std::string metric_name = protocol + "_packet_count";
@@ -72,4 +113,84 @@ auto PrometheusExporter::packet_count(const std::string& protocol) noexcept
         .Help("Incrementing counter of the number of received packets in a protocol layer.")
         .Labels({{"name", prometheus_name_}})
         .Register(*registry_);
-}
\ No newline at end of file
+}
+
+auto PrometheusExporter::borzoi_batch_size() noexcept -> prometheus::Family<prometheus::Histogram>& {
+    return prometheus::BuildHistogram()
+        .Name("borzoi_batch_size")
+        .Help("Histogram of the number of packets in a request to borzoi")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_request_latency() noexcept -> prometheus::Family<prometheus::Histogram>& {
+    return prometheus::BuildHistogram()
+        .Name("borzoi_request_latency")
+        .Help("Histogram of the time in seconds it takes to send a request to borzoi")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_request_body_bytes_count() noexcept -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("borzoi_request_body_bytes_count")
+        .Help("Incrementing counter of the bytes of the request bodies sent to borzoi")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_backlog_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("borzoi_backlog_gauge")
+        .Help("The gauge for the number of packets that wait to be sent to borzoi")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_in_flight_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("borzoi_in_flight_gauge")
+        .Help("The gauge for the number of requests that are queued or sent on the connections to borzoi")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_spool_size_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("borzoi_spool_size_gauge")
+        .Help("The gauge for the size of the spool of undelivered borzoi packets")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::borzoi_spool_record_count() noexcept -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("borzoi_spool_record_count")
+        .Help("Incrementing counter of the packets that pass through the spool of undelivered borzoi packets")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::output_sink_queue_gauge() noexcept -> prometheus::Family<prometheus::Gauge>& {
+    return prometheus::BuildGauge()
+        .Name("output_sink_queue_gauge")
+        .Help("The gauge for the number of packets in the queue of an output sink")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::output_sink_drop_count() noexcept -> prometheus::Family<prometheus::Counter>& {
+    return prometheus::BuildCounter()
+        .Name("output_sink_drop_count")
+        .Help("Incrementing counter of the packets dropped by an output sink")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
+
+auto PrometheusExporter::output_sink_lag() noexcept -> prometheus::Family<prometheus::Histogram>& {
+    return prometheus::BuildHistogram()
+        .Name("output_sink_lag")
+        .Help("Histogram of the time in seconds a packet waits in the queue of an output sink")
+        .Labels({{"name", prometheus_name_}})
+        .Register(*registry_);
+}
@@ -9,11 +9,62 @@
 
 #include "utils/bit_vector.hpp"
 #include <cassert>
+#include <cctype>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+
+namespace {
+
+/// The version of the json representation of the BitVector
+constexpr unsigned kJsonVersion = 1;
+
+/// The digits used in the hex json representation of the BitVector
+constexpr const char* kHexDigits = "0123456789abcdef";
+
+/// Write up to 64 bits into packed words. The destination bits must be zero.
+/// \param data the packed words
+/// \param position the position of the first bit to write
+/// \param value the bits to write with the last bit in the least significant bit
+/// \param number_bits the number of bits to write, must be between 1 and 64
+auto deposit(uint64_t* data, std::size_t position, uint64_t value, std::size_t number_bits) -> void {
+    constexpr std::size_t kWordBits = 64;
+    const auto word = position / kWordBits;
+    const auto bit = position % kWordBits;
+
+    const auto aligned = value << (kWordBits - number_bits);
+    data[word] |= aligned >> bit;
+    if (bit + number_bits > kWordBits) {
+        data[word + 1] |= aligned << (kWordBits - bit);
+    }
+}
+
+} // namespace
+
+auto BitVector::allocate(std::size_t number_bits) -> uint64_t* {
+    const auto number_words = (number_bits + kWordBits - 1) / kWordBits;
+
+    if (number_words <= kInlineWords) {
+        data_.reset();
+        inline_data_.fill(0);
+        return inline_data_.data();
+    }
+
+    auto data = std::make_shared<std::vector<uint64_t>>(number_words);
+    auto* words = data->data();
+    data_ = std::move(data);
+    return words;
+}
+
+auto BitVector::copy_view_into(uint64_t* data, std::size_t position) const -> void {
+    for (std::size_t offset = 0; offset < len_; offset += kWordBits) {
+        const auto chunk = std::min(len_ - offset, kWordBits);
+        deposit(data, position + offset, extract(read_offset_ + offset, chunk), chunk);
+    }
+}
 
 auto BitVector::compute_fcs() -> uint32_t {
     uint32_t crc = 0xFFFFFFFF;
@@ -22,7 +73,7 @@ auto BitVector::compute_fcs() -> uint32_t {
     }
 
     for (auto i = 0; i < len_; i++) {
-        bool bit = (static_cast<uint32_t>(data_[read_offset_ + i]) ^ (crc >> 31)) & 1;
+        bool bit = (static_cast<uint32_t>(bit_at(read_offset_ + i)) ^ (crc >> 31)) & 1;
         crc <<= 1;
         if (bit) {
             crc = crc ^ 0x04C11DB7;
@@ -32,25 +83,43 @@ auto BitVector::compute_fcs() -> uint32_t {
 }
 
 void BitVector::append(const BitVector& other) {
-    // actually need to do a copy here!
-    if (read_offset_ > 0) {
-        // copy to front
-        data_ = std::vector(data_.begin() + read_offset_, data_.begin() + read_offset_ + len_);
-        read_offset_ = 0;
-    }
-    // shrink the size
-    data_.resize(len_);
-
+    // actually need to do a copy here! the buffer may be shared with other bitvectors and may not be modified.
+    BitVector vec;
+    auto* data = vec.allocate(len_ + other.len_);
+    copy_view_into(data, 0);
     // copy in other
-    data_.insert(data_.end(), other.data_.begin() + other.read_offset_,
-                 other.data_.begin() + other.read_offset_ + other.len_);
+    other.copy_view_into(data, len_);
+
+    inline_data_ = vec.inline_data_;
+    data_ = std::move(vec.data_);
     len_ += other.len_;
+    read_offset_ = 0;
+}
+
+auto BitVector::concatenate(const std::vector<BitVector>& segments) -> BitVector {
+    std::size_t number_bits = 0;
+    for (const auto& segment : segments) {
+        number_bits += segment.len_;
+    }
+
+    BitVector vec;
+    auto* data = vec.allocate(number_bits);
+    for (const auto& segment : segments) {
+        segment.copy_view_into(data, vec.len_);
+        vec.len_ += segment.len_;
+    }
+
+    return vec;
 }
 
 auto BitVector::take_vector(std::size_t number_bits) -> BitVector {
-    const auto bits = data_.begin() + read_offset_;
+    const auto position = read_offset_;
 
     if (number_bits > bits_left()) {
+        if (non_throwing_) {
+            mark_truncated();
+            return {};
+        }
         throw std::runtime_error(std::to_string(number_bits) + " bits not left in BitVec (" +
                                  std::to_string(bits_left()) + ")");
     }
@@ -59,11 +128,21 @@ auto BitVector::take_vector(std::size_t number_bits) -> BitVector {
     read_offset_ += number_bits;
     len_ -= number_bits;
 
-    return BitVector(std::vector<bool>(bits, bits + number_bits));
+    // share the buffer or copy the inline storage and only select the range of bits
+    BitVector vec;
+    if (data_) {
+        vec.data_ = data_;
+    } else {
+        vec.inline_data_ = inline_data_;
+    }
+    vec.len_ = number_bits;
+    vec.read_offset_ = position;
+
+    return vec;
 }
 
 auto BitVector::take_all() -> uint64_t {
-    const auto bits = data_.begin() + read_offset_;
+    const auto position = read_offset_;
     const auto len = bits_left();
 
     if (len > 64) {
@@ -75,14 +154,11 @@ auto BitVector::take_all() -> uint64_t {
     read_offset_ += len;
     len_ -= len;
 
-    auto ret = static_cast<uint64_t>(bits[0]);
-
-    for (std::size_t i = 1; i < len; i++) {
-        ret <<= 1;
-        ret |= static_cast<uint64_t>(bits[i]);
+    if (len == 0) {
+        return 0;
     }
 
-    return ret;
+    return extract(position, len);
 };
 
 auto BitVector::is_mac_padding() const noexcept -> bool {
@@ -91,13 +167,14 @@ auto BitVector::is_mac_padding() const noexcept -> bool {
     }
 
     // first bit must be true
-    if (!data_[read_offset_]) {
+    if (!bit_at(read_offset_)) {
         return false;
     }
 
     // all other bits must be false
-    for (auto i = 1; i < len_; i++) {
-        if (data_[read_offset_ + i]) {
+    for (std::size_t offset = 1; offset < len_; offset += kWordBits) {
+        const auto chunk = std::min(len_ - offset, kWordBits);
+        if (extract(read_offset_ + offset, chunk) != 0) {
             return false;
         }
     }
@@ -108,8 +185,56 @@ auto BitVector::is_mac_padding() const noexcept -> bool {
 auto operator<<(std::ostream& stream, const BitVector& vec) -> std::ostream& {
     stream << "BitVec: ";
     for (auto i = 0; i < vec.len_; i++) {
-        stream << std::to_string(vec.data_[vec.read_offset_ + i]);
+        stream << std::to_string(vec.bit_at(vec.read_offset_ + i));
     }
 
     return stream;
 }
+
+auto to_json(nlohmann::json& json, const BitVector& vec) -> void {
+    // only serialize the bits in the current view as hex, MSB first. the last nibble is padded with zeros.
+    std::string data;
+    data.reserve((vec.len_ + 3) / 4);
+    for (std::size_t offset = 0; offset < vec.len_; offset += 4) {
+        const auto chunk = std::min<std::size_t>(vec.len_ - offset, 4);
+        const auto nibble = vec.extract(vec.read_offset_ + offset, chunk) << (4 - chunk);
+        data.push_back(kHexDigits[nibble]);
+    }
+
+    json = nlohmann::json{{"version", kJsonVersion}, {"length", vec.len_}, {"data", data}};
+}
+
+auto from_json(const nlohmann::json& json, BitVector& vec) -> void {
+    // data written before the versioned format contains the stored bits as an array of bools
+    if (!json.contains("version")) {
+        vec = BitVector(json.at("data_").get<std::vector<bool>>());
+        json.at("len_").get_to(vec.len_);
+        json.at("read_offset_").get_to(vec.read_offset_);
+        return;
+    }
+
+    const auto version = json.at("version").get<unsigned>();
+    if (version != kJsonVersion) {
+        throw std::runtime_error("Unsupported BitVector json version " + std::to_string(version));
+    }
+
+    const auto length = json.at("length").get<std::size_t>();
+    const auto data = json.at("data").get<std::string>();
+    if (data.size() != (length + 3) / 4) {
+        throw std::runtime_error("BitVector json data with " + std::to_string(data.size()) +
+                                 " hex digits does not match the length of " + std::to_string(length) + " bits");
+    }
+
+    vec = BitVector();
+    auto* words = vec.allocate(length);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        const auto* digit = std::strchr(kHexDigits, std::tolower(static_cast<unsigned char>(data[i])));
+        if (digit == nullptr || *digit == '\0') {
+            throw std::runtime_error("BitVector json data contains the invalid hex digit " + std::string(1, data[i]));
+        }
+        const auto chunk = std::min<std::size_t>(length - 4 * i, 4);
+        const auto nibble = static_cast<uint64_t>(digit - kHexDigits) >> (4 - chunk);
+        deposit(words, 4 * i, nibble, chunk);
+    }
+    vec.len_ = length;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "utils/complex_simd.hpp"
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+
+namespace {
+
+/// Multiply two complex values packed in each operand. Both operands hold (re0, im0, re1, im1).
+inline auto multiply_packed(__m128 lhs, __m128 rhs) noexcept -> __m128 {
+    // (rhs.re, rhs.re, ...) and (rhs.im, rhs.im, ...)
+    const __m128 rhs_re = _mm_moveldup_ps(rhs);
+    const __m128 rhs_im = _mm_movehdup_ps(rhs);
+    // (lhs.im, lhs.re, ...)
+    const __m128 lhs_swapped = _mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 3, 0, 1));
+    // (lhs.re * rhs.re - lhs.im * rhs.im, lhs.im * rhs.re + lhs.re * rhs.im)
+    return _mm_addsub_ps(_mm_mul_ps(lhs, rhs_re), _mm_mul_ps(lhs_swapped, rhs_im));
+}
+
+} // namespace
+#endif
+
+// std::complex<float> is guaranteed to be layout compatible with float[2], so two complex values fit in one __m128.
+
+auto complex_multiply_accumulate(const std::complex<float>* input, std::complex<float> factor,
+                                 std::complex<float>* acc, std::size_t len) noexcept -> void {
+    std::size_t i = 0;
+#if defined(__SSE4_1__)
+    const __m128 factor_packed = _mm_setr_ps(factor.real(), factor.imag(), factor.real(), factor.imag());
+    const auto* input_values = reinterpret_cast<const float*>(input);
+    auto* acc_values = reinterpret_cast<float*>(acc);
+    for (; i + 2 <= len; i += 2) {
+        const __m128 product = multiply_packed(_mm_loadu_ps(input_values + 2 * i), factor_packed);
+        _mm_storeu_ps(acc_values + 2 * i, _mm_add_ps(_mm_loadu_ps(acc_values + 2 * i), product));
+    }
+#endif
+    for (; i < len; i++) {
+        acc[i] += input[i] * factor;
+    }
+}
+
+auto complex_scale(const std::complex<float>* input, std::complex<float> factor, std::complex<float>* output,
+                   std::size_t len) noexcept -> void {
+    std::size_t i = 0;
+#if defined(__SSE4_1__)
+    const __m128 factor_packed = _mm_setr_ps(factor.real(), factor.imag(), factor.real(), factor.imag());
+    const auto* input_values = reinterpret_cast<const float*>(input);
+    auto* output_values = reinterpret_cast<float*>(output);
+    for (; i + 2 <= len; i += 2) {
+        _mm_storeu_ps(output_values + 2 * i, multiply_packed(_mm_loadu_ps(input_values + 2 * i), factor_packed));
+    }
+#endif
+    for (; i < len; i++) {
+        output[i] = input[i] * factor;
+    }
+}
+
+auto complex_multiply(const std::complex<float>* lhs, const std::complex<float>* rhs, std::complex<float>* output,
+                      std::size_t len) noexcept -> void {
+    std::size_t i = 0;
+#if defined(__SSE4_1__)
+    const auto* lhs_values = reinterpret_cast<const float*>(lhs);
+    const auto* rhs_values = reinterpret_cast<const float*>(rhs);
+    auto* output_values = reinterpret_cast<float*>(output);
+    for (; i + 2 <= len; i += 2) {
+        _mm_storeu_ps(output_values + 2 * i,
+                      multiply_packed(_mm_loadu_ps(lhs_values + 2 * i), _mm_loadu_ps(rhs_values + 2 * i)));
+    }
+#endif
+    for (; i < len; i++) {
+        output[i] = lhs[i] * rhs[i];
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2024 Transit Live Mapping Solutions
+ * All rights reserved.
+ *
+ * Authors:
+ *   Marenz Schmidl
+ */
+
+#include "utils/iq_format.hpp"
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#endif
+
+namespace {
+
+constexpr float kInt8Scale = 1.0F / 128.0F;
+constexpr float kInt16Scale = 1.0F / 32768.0F;
+
+/// Convert interleaved signed 8-bit IQ samples into floats. 16 values (8 complex samples) are converted per iteration.
+auto convert_int8(const int8_t* input, std::size_t value_count, float* output) -> void {
+    std::size_t i = 0;
+#if defined(__SSE4_1__)
+    const __m128 scale = _mm_set1_ps(kInt8Scale);
+    for (; i + 16 <= value_count; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i v0 = _mm_cvtepi8_epi32(bytes);
+        const __m128i v1 = _mm_cvtepi8_epi32(_mm_srli_si128(bytes, 4));
+        const __m128i v2 = _mm_cvtepi8_epi32(_mm_srli_si128(bytes, 8));
+        const __m128i v3 = _mm_cvtepi8_epi32(_mm_srli_si128(bytes, 12));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v0), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(v1), scale));
+        _mm_storeu_ps(output + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(v2), scale));
+        _mm_storeu_ps(output + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(v3), scale));
+    }
+#endif
+    for (; i < value_count; i++) {
+        output[i] = static_cast<float>(input[i]) * kInt8Scale;
+    }
+}
+
+/// Convert interleaved signed 16-bit IQ samples into floats. 8 values (4 complex samples) are converted per iteration.
+auto convert_int16(const int16_t* input, std::size_t value_count, float* output) -> void {
+    std::size_t i = 0;
+#if defined(__SSE4_1__)
+    const __m128 scale = _mm_set1_ps(kInt16Scale);
+    for (; i + 8 <= value_count; i += 8) {
+        const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        const __m128i v0 = _mm_cvtepi16_epi32(words);
+        const __m128i v1 = _mm_cvtepi16_epi32(_mm_srli_si128(words, 8));
+        _mm_storeu_ps(output + i, _mm_mul_ps(_mm_cvtepi32_ps(v0), scale));
+        _mm_storeu_ps(output + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(v1), scale));
+    }
+#endif
+    for (; i < value_count; i++) {
+        output[i] = static_cast<float>(input[i]) * kInt16Scale;
+    }
+}
+
+} // namespace
+
+auto iq_format_from_string(const std::string& name) -> IQFormat {
+    for (auto format : {IQFormat::kComplexFloat32, IQFormat::kComplexInt16, IQFormat::kComplexInt8}) {
+        if (name == to_string(format)) {
+            return format;
+        }
+    }
+    throw std::runtime_error("Unknown IQ format: " + name + ". Supported formats are cf32, cs16 and cs8.");
+}
+
+auto convert_iq_samples(IQFormat format, const uint8_t* input, std::size_t sample_count, std::complex<float>* output)
+    -> void {
+    // std::complex<float> is guaranteed to be layout compatible with float[2]
+    auto* output_values = reinterpret_cast<float*>(output);
+
+    switch (format) {
+    case IQFormat::kComplexFloat32:
+        std::memcpy(output, input, sample_count * bytes_per_sample(format));
+        break;
+    case IQFormat::kComplexInt16:
+        convert_int16(reinterpret_cast<const int16_t*>(input), 2 * sample_count, output_values);
+        break;
+    case IQFormat::kComplexInt8:
+        convert_int8(reinterpret_cast<const int8_t*>(input), 2 * sample_count, output_values);
+        break;
+    }
+}